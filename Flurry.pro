@@ -29,10 +29,12 @@ HEADERS += include/global.hpp \
     include/output.hpp \
     include/face.hpp \
     include/flux.hpp \
+    include/physics.hpp \
     include/flurry.hpp \
     include/solver.hpp \
     include/error.hpp \
-    include/bound.hpp
+    include/bound.hpp \
+    include/genKernels.hpp
 
 DISTFILES += \
     README.md \
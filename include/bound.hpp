@@ -18,6 +18,22 @@
 
 #include "global.hpp"
 #include "input.hpp"
+
+/*! Reference [freestream] values used by the boundary conditions, computed once from
+ *  the input parameters rather than at every boundary flux point */
+struct bcState
+{
+  double vBound[3];     //! Boundary velocity
+  double keSubIn;       //! Kinetic energy of the SUB_IN state, 0.5*rho*|v|^2
+  double uSupIn[5];     //! Conservative SUP_IN state
+  double cTermBound;    //! [CHAR] Acoustic term of the incoming Riemann invariant, 2c/(gamma-1)
+  double oneOverSBound; //! [CHAR] Inverse entropy, rho^gamma/p
+  double hBound;        //! [CHAR] Total enthalpy
+
+  void setup(input *params);
+};
+
+// Included after bcState: ele.hpp brings in solver.hpp, which holds a bcState
 #include "ele.hpp"
 #include "flux.hpp"
 
@@ -28,8 +44,14 @@ public:
   /*! Setup access to the left & right elements' data */
   void setupBound(ele *eL, int locF_L, int bcType, int gID);
 
-  /*! Calculate the inviscid flux from the boundary condition */
-  void calcInviscidFlux(void);
+  /*! Calculate the inviscid flux from the boundary condition (of type bcType) */
+  template<class Physics, int bcType>
+  void calcInviscidFlux(const bcState &bc);
+
+  /*! Calculate the inviscid flux on bounds[start:end], which must all have the given bcType,
+   *  using the kernel specialized for that boundary condition */
+  template<class Physics>
+  static void calcInviscidFluxGroup(vector<bound> &bounds, int start, int end, int bcType, const bcState &bc);
 
   /*! Calculate the viscous flux from the boundary condition */
   void calcViscousFlux(void);
@@ -38,7 +60,11 @@ public:
 
   input *params; //! Input parameters for simulation
 
-  void applyBCs(const double *uL, double* uR, const double* norm);
+  int getBcType(void) const;
+
+  /*! Set the ghost [right] state uR for a boundary condition of type bcType */
+  template<class Physics, int bcType>
+  void applyBC(const double *uL, double* uR, const double* norm, const bcState &bc);
 
 private:
   int nFptsL;
@@ -47,12 +73,11 @@ private:
   int locF_L;
 
   /* --- Storage for all solution/geometry data at flux points --- */
-  vector<double*> UL;       //! Discontinuous solution at element boundary
+  vector<flt*> UL;          //! Discontinuous solution at element boundary
   matrix<double> UR;        //! Boundary condition from "ghost right state"
-  vector<double*> disFnL;   //! Discontinuous normal flux at element boundary
+  vector<flt*> disFnL;      //! Discontinuous normal flux at element boundary
   vector<matrix<double>*> gradUL;
-  vector<matrix<double*>> FL;
-  vector<double*> dFnL;     //! Common minus discontinuous normal flux for ele
+  vector<flt*> dFnL;        //! Common minus discontinuous normal flux for ele
   matrix<double> Fn;        //! Common normal flux on boundary
   vector<double*> deltaF;
   matrix<double> normL;
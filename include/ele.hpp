@@ -25,6 +25,26 @@
 #include "matrix.hpp"
 #include "solver.hpp"
 
+//! Bytes of storage held by an element, by category [see ele::getMemUsage]
+struct eleMemUsage
+{
+  size_t solution = 0;  //! Solution at spts/fpts/mpts, RK & physical time levels
+  size_t flux = 0;      //! Flux at spts, normal fluxes at fpts, divergence of flux
+  size_t gradients = 0; //! Gradients of solution & flux
+  size_t geometry = 0;  //! Transforms, normals & point positions
+  size_t motion = 0;    //! Shape bases, grid velocity & moving node positions
+  size_t other = 0;     //! Connectivity & temporary storage
+
+  size_t total(void) const {return solution+flux+gradients+geometry+motion+other;}
+
+  eleMemUsage& operator+=(const eleMemUsage &m)
+  {
+    solution += m.solution;  flux += m.flux;  gradients += m.gradients;
+    geometry += m.geometry;  motion += m.motion;  other += m.other;
+    return *this;
+  }
+};
+
 class ele
 {
 friend class face;
@@ -60,6 +80,9 @@ public:
 
   void calcTransforms(void);
 
+  //! Check whether the Jacobian is the same [to round-off] at all spts & fpts, i.e. the element is affine
+  bool isMetricConstant(void);
+
   void updateTransforms(void);
 
   void calcPosSpts(void);
@@ -84,6 +107,9 @@ public:
 
   void setInitialCondition(void);
 
+  /*! Calculate the inviscid flux at the solution points (transformed to the reference
+   *  domain unless the mesh is moving) */
+  template<class Physics>
   void calcInviscidFlux_spts(void);
 
   void calcViscousFlux_spts(void);
@@ -91,11 +117,38 @@ public:
   void transformGradF_spts(int step);
 
   /*! Advance intermediate stages of Runge-Kutta time integration */
+  template<class Physics>
   void timeStepA(int step, double rkVal);
 
   /*! Perform final advancement of Runge-Kutta time integration */
+  template<class Physics>
   void timeStepB(int step, double rkVal);
 
+  /*! Add the BDF physical-time source term to the residual (dual time stepping) */
+  void addPhysicalSource(int step, int bdfOrder);
+
+  /*! Shift the stored physical time levels: Unm1 <- Un <- U_spts */
+  void shiftTimeLevels(void);
+
+  /*! Calculate the local (point-implicit scaled) pseudo time step for dual time stepping */
+  void calcDtau(void);
+
+  /*! Apply the low-Mach preconditioner to the residual at each solution point */
+  template<class Physics>
+  void preconditionResidual(int step);
+
+  /*! Get the physical residual (divF / detJac) at each solution point [nSpts x nFields] */
+  void getPhysResidual(int step, double* res);
+
+  /*! Set divF from the given physical residual at each solution point [nSpts x nFields] */
+  void setPhysResidual(int step, const double* res);
+
+  /*! Release all setup-only data not needed by the time loop or output; returns the # of bytes released */
+  size_t releaseSetupData(void);
+
+  /*! Get the # of bytes currently held by this element's data arrays, by category */
+  eleMemUsage getMemUsage(void);
+
   /*! Copy U0_spts into U_spts for final time advancement */
   void copyU0_Uspts(void);
   void copyUspts_U0(void);
@@ -149,29 +202,33 @@ private:
 
   /* --- Solution Variables --- */
   // Solution, flux
-  matrix<double> U_spts;           //! Solution at solution points
-  matrix<double> U_fpts;           //! Solution at flux points
-  matrix<double> U_mpts;           //! Solution at mesh (corner) points
-  matrix<double> U0;               //! Solution at solution points, beginning of each time step
-  vector<matrix<double> > F_spts;  //! Flux at solution points
-  vector<matrix<double> > F_fpts;  //! Flux at flux points
-  matrix<double> Fn_fpts;          //! Interface flux at flux points
-  matrix<double> dFn_fpts;         //! Interface minus discontinuous flux at flux points
+  matrix<flt> U_spts;              //! Solution at solution points
+  matrix<flt> U_fpts;              //! Solution at flux points
+  matrix<flt> U_mpts;              //! Solution at mesh (corner) points [allocated on first output]
+  matrix<flt> U0;                  //! Solution at solution points, beginning of each time step
+  matrix<flt> Un;                  //! Solution at solution points, physical time level n [dual time stepping]
+  matrix<flt> Unm1;                //! Solution at solution points, physical time level n-1 [dual time stepping]
+  double dtau;                     //! Local pseudo time step [dual time stepping]
+  vector<matrix<flt> > F_spts;     //! Flux at solution points
+  matrix<flt> Fn_fpts;             //! Interface flux at flux points
+  matrix<flt> dFn_fpts;            //! Interface minus discontinuous flux at flux points
 
   // Gradients
-  vector<matrix<double> > dU_spts;  //! Gradient of solution at solution points
-  vector<matrix<double> > dU_fpts;  //! Gradient of solution at flux points
-  vector<vector<matrix<double>>> dF_spts;  //! Gradient of flux at solution points
-  vector<matrix<double>> divF_spts;         //! Divergence of flux at solution points
-  vector<matrix<double>> tdF_spts;          //! Transformed gradient of flux (dF_dxi and dG_deta) at solution points
+  vector<matrix<flt> > dU_spts;     //! Gradient of solution at solution points [viscous or moving mesh only]
+  vector<matrix<flt> > dU_fpts;     //! Gradient of solution at flux points [viscous only]
+  vector<vector<matrix<flt>>> dF_spts;     //! Gradient of flux at solution points [moving mesh only]
+  vector<matrix<flt>> divF_spts;            //! Divergence of flux at solution points
 
   // Transform Variables
   vector<double> detJac_spts;  //! Determinant of transformation Jacobian at each solution point
   vector<double> detJac_fpts;  //! Determinant of transformation Jacobian at each solution point
   vector<matrix<double> > Jac_spts;  //! Transformation Jacobian [matrix] at each solution point
   vector<matrix<double> > Jac_fpts;  //! Transformation Jacobian [matrix] at each flux point
-  vector<matrix<double> > JGinv_spts;  //! Inverse of transformation Jacobian [matrix] at each solution point
+  matrix<double> JGinv_spts;  //! Inverse of transformation Jacobian (times detJac), stored SoA: row i*nDims+j holds entry (i,j) at every solution point [single column if constMetric]
+  bool constMetric;           //! [Static mesh] Affine element: the metric is constant, and only one copy is stored [JGinv_spts, Jac_spts, Jac_fpts]
   
+
+  // Moving-mesh data [on a static mesh, the shape bases & Jacobians are released once the transforms are set]
   matrix<double> shape_spts;
   matrix<double> shape_fpts;
   vector<matrix<double>> dShape_spts;  //! Derivative of shape basis at solution points
@@ -19,30 +19,19 @@
 #include "input.hpp"
 #include "matrix.hpp"
 
-/*! Calculate the inviscid portion of the Euler or Navier-Stokes flux vector at a point */
-void inviscidFlux(double* U, matrix<double> &F, input *params);
-
 /*! Calculate the viscous portion of the Navier-Stokes flux vector at a point */
 void viscousFlux(double *U, matrix<double> &gradU, matrix<double> &Fvis, input *params);
 
 /*! Calculate the common inviscid flux at a point using Roe's method */
 void roeFlux(double* uL, double* uR, double *norm, double *Fn, input *params);
 
-/*! Calculate the common inviscid flux at a point using the Rusanov scalar-diffusion method */
-void rusanovFlux(double* UL, double* UR, matrix<double> &FL, matrix<double> &FR, double *norm, double *Fn, input *params);
-//void rusanovFlux(vector<double> &UL, vector<double> &UR, vector<vector<double*>> &FL, vector<vector<double*>> &FR, vector<double> &norm, vector<double> &Fn, input *params);
-
-/*! Simple central-difference flux (For advection problems) */
-void centralFlux(double* uL, double* uR, double *norm, double *Fn, input *params);
-
-/*! Simple central-difference flux (For Navier-Stokes problems) */
-void centralFlux(matrix<double> &FL, matrix<double> &FR, double* norm, double* Fn, input *params);
-
-/*! Simple upwinded flux (primarily for advection problems) */
-void upwindFlux(double* uL, double* uR, double *norm, double *Fn, input *params);
+/*! Apply the low-Mach preconditioner (Weiss-Smith / Turkel) to a residual vector in-place
+ *  (Conservative variables; nDims==2 only) */
+void lowMachPrecondition(double* U, double* R, input *params);
 
-/*! Lax-Friedrichs flux (advection-diffusion) */
-void laxFriedrichsFlux(double* uL, double* uR, double *norm, double *Fn, input *params);
+/*! Calculate the preconditioned scalar dissipation term (P^-1 |PA|) dU at the given state
+ *  [used by Euler2D::interfaceFlux when params->lowMachPrecon is set] */
+void lowMachDissipation(double rho, double u, double v, double p, double vn, double* dU, double* diss, input *params);
 
 /*! Calculate the common viscous flux at a point using the LDG penalty method */
 void ldgFlux(double* uL, double* uR, matrix<double> &gradU_L, matrix<double> &gradU_R, double *Fn, input *params);
@@ -0,0 +1,44 @@
+/*!
+ * \file genKernels.hpp
+ * \brief Interface to the order-specialized FR operator kernels written by kernelGen
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 0.0.1
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2014 Jacob Crabill.
+ *
+ */
+#pragma once
+
+#include "global.hpp"
+
+/*! All kernels act on row-major [nPts x nFields] data */
+
+//! B = A*U for a fixed operator A
+typedef void (*genKernelFn)(const flt* U, flt* B, int nFields);
+
+//! B = sum_dim A_dim*F[dim] for the fixed gradient operators A_dim
+typedef void (*genDivKernelFn)(const flt* const* F, flt* B, int nFields);
+
+/*! Set of generated kernels for one element type, order, point type & correction scheme */
+struct genKernelSet
+{
+  int eType;
+  int nDims;
+  int order;
+  const char* sptsType;
+  int vcjhScheme;
+
+  genKernelFn sptsFpts;    //! U_fpts = opp_spts_to_fpts * U_spts
+  genKernelFn grad[3];     //! dU_spts[dim] = opp_grad_spts[dim] * U_spts
+  genDivKernelFn divF;     //! divF_spts = sum_dim opp_grad_spts[dim] * F_spts[dim]
+  genKernelFn correction;  //! divF_spts += opp_correction * dFn_fpts
+};
+
+//! Table of all generated kernel sets [defined in the generated genKernels.cpp]
+extern const genKernelSet genKernels[];
+extern const int nGenKernels;
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "global.hpp"
@@ -34,12 +35,19 @@ public:
   //! Setup the geomery using input parameters
   void setup(input* params);
 
+  //! Setup only what is needed for the reference-element points & FR operators, without any mesh [kernelGen]
+  void setupReference(input* params);
+
   //! Take the basic connectivity data and generate the rest
   void processConnectivity();
 
   //! Create the elements and faces needed for the simulation
   void setupElesFaces(vector<ele> &eles, vector<face> &faces, vector<bound> &bounds);
 
+  /*! Release all connectivity data not needed once the elements & faces are setup
+   *  (all but c2c); returns the # of bytes released */
+  size_t releaseConnectivity(void);
+
   /* === Helper Routines === */
 
   //! Read essential connectivity from a Gmsh mesh file
@@ -63,6 +71,13 @@ public:
   int nDims, nFields;
   int nEles, nVerts, nEdges, nFaces, nBndEdges;
 
+  matrix<int> c2c;  //! Cell-to-cell (face neighbor) connectivity [-1 on boundaries]
+
+  //! Local face ID, within its neighbor c2c[ic][locF], of face locF of cell ic [-1 on boundaries; needs c2e]
+  int getNbLocalFace(int ic, int locF);
+
+  bool periodicX, periodicY;  //! [Structured mesh] Whether the x (left/right) & y (bottom/top) boundaries are periodic
+
 private:
 
   input *params;
@@ -73,6 +88,7 @@ private:
 
   // Additional Connectivity Data
   matrix<int> c2e, c2b, e2c, e2v, v2e, v2v, v2c;
+  matrix<int> e2lf;              //! Local face ID of each edge within its left [0] & right [1] cells
   vector<int> v2nv, v2nc, c2nv, c2ne, ctype;
   vector<int> intEdges, bndEdges;
   vector<int> bcList;            //! List of boundary conditions for each boundary
@@ -81,6 +97,7 @@ private:
   vector<int> nBndPts;           //! Number of points on each boudary
   vector<matrix<int> > bndFaces; //! List of nodes on each face (edge) on each boundary
   vector<int> nBndFaces;         //! List of # of faces on each boundary
+  unordered_map<uint64_t,int> bndEdgeTags; //! Boundary of each boundary face given in the mesh file, keyed on its corner vertices
   //map<string,int> bcNum;         //! Maps a boundary-condition string to its integer enum
   vector<bool> isBnd; // might want to change this to "int" and have it store WHICH boundary the face is on (-1 for internal)
   int nBounds;  //! Number of boundaries
@@ -90,4 +107,22 @@ private:
 
   //! Check if two given periodic edges match up
   bool checkPeriodicFaces(int *edge1, int *edge2);
+
+  //! Setup the cell-to-cell connectivity from the final e2c, c2e
+  void setupNeighbors(void);
+
+  /*! Setup all connectivity for a structured Cartesian mesh arithmetically from the (i,j) cell indices
+   *  Only boundary edges are stored in e2c/e2lf/bndEdges; interior faces are handled by the solver directly */
+  void setupStructured(void);
+
+  /* --- Preprocessed-Mesh Cache --- */
+
+  //! Hash of the mesh file (or mesh-creation options) & other connectivity-related inputs
+  uint64_t getMeshHash(void);
+
+  //! Write the preprocessed mesh & connectivity to a binary cache file
+  void writeMeshCache(string fileName, uint64_t hash);
+
+  //! Read the preprocessed mesh & connectivity from a cache file; returns false if missing or stale
+  bool readMeshCache(string fileName, uint64_t hash);
 };
@@ -1,5 +1,6 @@
 #include "global.hpp"
 #include "geo.hpp"
+#include "polynomials.hpp"
 
 vector<point> geo::getLocSpts(int eType, int order)
 {
@@ -423,197 +424,17 @@ vector<point> geo::getLocFpts(int eType, int order)
 
 vector<double> geo::getPts1D(string ptsType, int order)
 {
-  vector<double> outPts(order+1);
+  vector<double> outPts;
 
   if (!ptsType.compare("Legendre")) { // Gauss-Legendre
-    if (order == 0) {
-      outPts[0] =  0.0;
-    }
-    else if(order == 1) {
-      outPts[0] = -0.577350269189626;
-      outPts[1] =  0.577350269189626;
-    }
-    else if(order == 2) {
-      outPts[0] = -0.774596669241483;
-      outPts[1] =  0.000000000000000;
-      outPts[2] =  0.774596669241483;
-    }
-    else if(order == 3) {
-      outPts[0] = -0.861136311594053;
-      outPts[1] = -0.339981043584856;
-      outPts[2] =  0.339981043584856;
-      outPts[3] =  0.861136311594053;
-    }
-    else if(order == 4) {
-      outPts[0] = -0.906179845938664;
-      outPts[1] = -0.538469310105683;
-      outPts[2] =  0.000000000000000;
-      outPts[3] =  0.538469310105683;
-      outPts[4] =  0.906179845938664;
-    }
-    else if(order == 5) {
-      outPts[0] = -0.932469514203152;
-      outPts[1] = -0.661209386466264;
-      outPts[2] = -0.238619186083197;
-      outPts[3] =  0.238619186083197;
-      outPts[4] =  0.661209386466265;
-      outPts[5] =  0.932469514203152;
-    }
-    else if(order == 6) {
-      outPts[0] = -0.949107912342758;
-      outPts[1] = -0.741531185599395;
-      outPts[2] = -0.405845151377397;
-      outPts[3] =  0.000000000000000;
-      outPts[4] =  0.405845151377397;
-      outPts[5] =  0.741531185599394;
-      outPts[6] =  0.949107912342758;
-    }
-    else if(order == 7) {
-      outPts[0] = -0.960289856497536;
-      outPts[1] = -0.796666477413627;
-      outPts[2] = -0.525532409916329;
-      outPts[3] = -0.183434642495650;
-      outPts[4] =  0.183434642495650;
-      outPts[5] =  0.525532409916329;
-      outPts[6] =  0.796666477413627;
-      outPts[7] =  0.960289856497536;
-    }
-    else if(order == 8) {
-      outPts[0] = -0.968160239507626;
-      outPts[1] = -0.836031107326636;
-      outPts[2] = -0.613371432700591;
-      outPts[3] = -0.324253423403809;
-      outPts[4] =  0.000000000000000;
-      outPts[5] =  0.324253423403809;
-      outPts[6] =  0.613371432700591;
-      outPts[7] =  0.836031107326636;
-      outPts[8] =  0.968160239507626;
-    }
-    else if(order == 9) {
-      outPts[0] = -0.973906528517172;
-      outPts[1] = -0.865063366688985;
-      outPts[2] = -0.679409568299024;
-      outPts[3] = -0.433395394129247;
-      outPts[4] = -0.148874338981631;
-      outPts[5] =  0.148874338981632;
-      outPts[6] =  0.433395394129247;
-      outPts[7] =  0.679409568299024;
-      outPts[8] =  0.865063366688984;
-      outPts[9] =  0.973906528517171;
-    }
-    else if(order == 10) {
-      outPts[0] = -0.978228658146057;
-      outPts[1] = -0.887062599768095;
-      outPts[2] = -0.730152005574049;
-      outPts[3] = -0.519096129206812;
-      outPts[4] = -0.269543155952345;
-      outPts[5] =  0.000000000000000;
-      outPts[6] =  0.269543155952345;
-      outPts[7] =  0.519096129206812;
-      outPts[8] =  0.730152005574049;
-      outPts[9] =  0.887062599768095;
-      outPts[10]=  0.978228658146057;
-    }
-    else {
-      stringstream ss; ss << order;
-      string errMsg = "Gauss-Ledgendre point locations for order " + ss.str() + " not implemented.";
-      FatalError(errMsg.c_str());
-    }
+    outPts = getGaussLegendrePts(order+1);
   }
   else if (!ptsType.compare("Lobatto")) { // Gauss-Lobatto
-    if (order == 0) {
-        outPts[0] =  0.0;
-    }
-    else if(order == 1) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] =  1.000000000000000;
-    }
-    else if(order == 2) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.000000000000000;
-      outPts[2] =  1.000000000000000;
-    }
-    else if(order == 3) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.447213595499958;
-      outPts[2] =  0.447213595499958;
-      outPts[3] =  1.000000000000000;
-    }
-    else if(order == 4) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.654653670707977;
-      outPts[2] = -0.000000000000000;
-      outPts[3] =  0.654653670707977;
-      outPts[4] =  1.000000000000000;
-    }
-    else if(order == 5) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.765055323929465;
-      outPts[2] = -0.285231516480645;
-      outPts[3] =  0.285231516480645;
-      outPts[4] =  0.765055323929465;
-      outPts[5] =  1.000000000000000;
-    }
-    else if(order == 6) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.830223896278567;
-      outPts[2] = -0.468848793470714;
-      outPts[3] =  0.000000000000000;
-      outPts[4] =  0.468848793470714;
-      outPts[5] =  0.830223896278567;
-      outPts[6] =  1.000000000000000;
-    }
-    else if(order == 7) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.871740148509607;
-      outPts[2] = -0.591700181433142;
-      outPts[3] = -0.209299217902479;
-      outPts[4] =  0.209299217902479;
-      outPts[5] =  0.591700181433142;
-      outPts[6] =  0.871740148509607;
-      outPts[7] =  1.000000000000000;
-    }
-    else if(order == 8) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.899757995411460;
-      outPts[2] = -0.677186279510738;
-      outPts[3] = -0.363117463826178;
-      outPts[4] = -0.000000000000000;
-      outPts[5] =  0.363117463826178;
-      outPts[6] =  0.677186279510738;
-      outPts[7] =  0.899757995411460;
-      outPts[8] =  1.000000000000000;
-    }
-    else if(order == 9) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.919533908166459;
-      outPts[2] = -0.738773865105505;
-      outPts[3] = -0.477924949810445;
-      outPts[4] = -0.165278957666387;
-      outPts[5] =  0.165278957666387;
-      outPts[6] =  0.477924949810444;
-      outPts[7] =  0.738773865105505;
-      outPts[8] =  0.919533908166459;
-      outPts[9] =  1.000000000000000;
-    }
-    else if(order == 10) {
-      outPts[0] = -1.000000000000000;
-      outPts[1] = -0.934001430408059;
-      outPts[2] = -0.784483473663144;
-      outPts[3] = -0.565235326996205;
-      outPts[4] = -0.295758135586939;
-      outPts[5] =  0.000000000000000;
-      outPts[6] =  0.295758135586939;
-      outPts[7] =  0.565235326996205;
-      outPts[8] =  0.784483473663144;
-      outPts[9] =  0.934001430408059;
-      outPts[10] =  1.000000000000000;
-    }
-    else {
-      stringstream ss;  ss << order;
-      string errMsg = "Gauss-Lobatto point locations for order " + ss.str() + " not implemented.";
-      FatalError(errMsg.c_str());
-    }
+    outPts = getGaussLobattoPts(order+1);
+  }
+  else {
+    string errMsg = "Point type " + ptsType + " not recognized.";
+    FatalError(errMsg.c_str());
   }
 
   return outPts;
@@ -43,6 +43,22 @@ using namespace std;
 
 typedef unsigned int uint;
 
+/*! Storage precision of the solution, flux & FR operator arrays [float if built with MIXED=yes].
+ *  Riemann solves, residual norms & the time update always compute in double precision. */
+#ifdef _MIXED_PRECISION
+typedef float flt;
+#else
+typedef double flt;
+#endif
+
+//! Get a double-precision view of u[0:n], copying into tmp only if stored in single precision
+inline double* getDouble(double* u, int, double*) {return u;}
+inline double* getDouble(float* u, int n, double* tmp)
+{
+  for (int i=0; i<n; i++) tmp[i] = u[i];
+  return tmp;
+}
+
 /* --- Misc. Common Constants / Globally-Useful Variables --- */
 extern double pi;
 
@@ -93,6 +109,21 @@ enum VCJH_SCHEME {
   CPLUS = 3
 };
 
+/*! Enumeration for the FR operators which have multiple kernel implementations */
+enum OPER_TYPE {
+  OPER_SPTS_FPTS  = 0,  //! Extrapolation from solution points to flux points
+  OPER_GRAD       = 1,  //! Gradient / divergence at solution points
+  OPER_CORRECTION = 2   //! Divergence of the correction function
+};
+
+/*! Enumeration for the kernels available to apply an FR operator */
+enum OPER_KERNEL {
+  DENSE_KERNEL  = 0,  //! Dense matrix product (matrix::timesMatrix)
+  LINE_KERNEL   = 1,  //! Tensor-product line (sum-factorized) form
+  INJECT_KERNEL = 2,  //! Index gather [collocated points]
+  GEN_KERNEL    = 3   //! Unrolled kernel generated by kernelGen for a fixed order [make GENKERNELS=yes]
+};
+
 /*! For convinience with geometry, a simple struct to hold an x,y,z coordinate */
 struct point
 {
@@ -193,6 +224,22 @@ T getMax(vector<T> &vec)
   return max;
 }
 
+/*! Release all memory held by vec; returns the number of bytes released */
+template<typename T>
+size_t freeVector(vector<T> &vec)
+{
+  size_t bytes = vec.capacity()*sizeof(T);
+  vector<T>().swap(vec);
+  return bytes;
+}
+
+inline size_t freeVector(vector<bool> &vec)
+{
+  size_t bytes = (vec.capacity()+7)/8;
+  vector<bool>().swap(vec);
+  return bytes;
+}
+
 template<typename T>
 void addVectors(vector<T> &vec1, vector<T> &vec2)
 {
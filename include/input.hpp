@@ -85,6 +85,14 @@ public:
   int test_case;
   int motion;
 
+  /* --- p-Sequencing Parameters --- */
+  int pSeq;            //! {0 | Off} {1 | Start at low order & elevate to 'order'}
+  int pSeqStart;       //! Polynomial order to start the simulation at
+  double pSeqResDrop;  //! Drop in the residual, relative to its peak at the current order, required before elevating the order
+  int pSeqScaleDt;     //! Scale dt by (2*orderFinal+1)/(2*order+1) at the lower orders
+  int orderFinal;      //! Final (target) polynomial order
+  double dtFinal;      //! Time step to use at the final polynomial order
+
   /* --- Simulation Run Parameters --- */
   int nFields;
   int nDims;
@@ -103,9 +111,23 @@ public:
   int monitor_res_freq;
   int iter;
   double beta;
+  int dualTime;          //! {0 | Off} {1 | BDF2 dual time stepping, using RK as the pseudo-time smoother}
+  double CFLtau;         //! Pseudo-time CFL number for the local pseudo time step
+  int nInnerIters;       //! Max. number of pseudo-time iterations per physical time step
+  double innerTol;       //! Relative drop in the pseudo-time residual at which to stop inner iterations
+  double convResDrop;    //! Stop once the residual has dropped by this factor from its peak [0 to disable]
+  int convStagWindow;    //! Stop if the residual hasn't reached a new minimum in this many residual outputs [0 to disable]
+  double convStagTol;    //! Relative improvement on the minimum residual required within convStagWindow
+  int resSmooth;         //! {0 | Off} {1 | Implicit residual smoothing before each RK stage update}
+  double resSmoothEps;   //! Residual-smoothing coefficient
+  int resSmoothIters;    //! Number of Jacobi sweeps for residual smoothing [even]
   bool slipPenalty;  //! Use "penalty method" on slip-wall boundary
+  int lowMachPrecon; //! Use Weiss-Smith/Turkel low-Mach preconditioning (steady problems only)
+  double precondEps; //! Cutoff for reference velocity, as a fraction of the freestream velocity
+  double vMagInf;    //! Freestream velocity magnitude
 
   string dataFileName;
+  string refSolutionFile;  //! CSV solution [plot_type 0] to compare against at the end of the run, e.g. from an all-double build
 
   /* --- Boundary & Initial Condition Parameters --- */
   double Uinf;
@@ -142,6 +164,10 @@ public:
   int nx, ny;
   double xmin, xmax, ymin, ymax;
   double periodicTol, periodicDX, periodicDY;
+  int meshCache;         //! Read/write the preprocessed mesh & connectivity from/to a binary cache file
+  string meshCacheFile;  //! Name of the mesh cache file
+  int structuredMesh;    //! [CREATE_MESH only] Use implicit (i,j) connectivity & line-sweep face fluxes; no face objects
+  int leanMemory;        //! Release mesh connectivity & setup-only element data once the solver is setup
   string create_bcTop, create_bcBottom, create_bcLeft, create_bcRight; //! BC's to apply to Flurry-created mesh
   //map<string,int> bcNum;
   map<string,string> meshBounds;
@@ -151,6 +177,12 @@ public:
   string sptsTypeQuad;
   int vcjhSchemeTri;
   int vcjhSchemeQuad;
+  int denseOperators;  //! Always apply the full dense operator matrices [for verification of the structured kernels]
+  int autotune;        //! Benchmark the available kernels for each operator at startup & use the fastest
+  int autotuneReps;    //! Number of timed repetitions of each kernel
+  string autotuneFile; //! File in which to cache the autotuned kernel choices
+  int operCache;       //! Read/write the FR operator matrices from/to binary cache files
+  string operCacheDir; //! Directory in which to store the operator cache files
 
 private:
   fileReader opts;
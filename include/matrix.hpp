@@ -64,9 +64,17 @@ public:
   /* --- Member Functions --- */
   void setup(uint inDim0, uint inDim1);
 
+  //! Release all storage & reset the dimensions to 0
+  void clear(void);
+
+  //! Get the number of bytes of storage currently allocated
+  size_t getMemSize(void) const {return data.capacity()*sizeof(T);}
+
   //! Adds the matrix a*A to current matrix (M += a*A)
   void addMatrix(matrix<T> &A, double a);
 
+  /* --- Matrix products: with _BLAS defined [make BLAS=yes], matrix<double> calls CBLAS dgemm --- */
+
   //! Multiplies the matrix by the matrix A and stores the result in B (B = M*A)
   void timesMatrix(matrix<T> &A, matrix<T> &B);
 
@@ -15,14 +15,39 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "global.hpp"
 
+#include "genKernels.hpp"
 #include "geo.hpp"
 #include "input.hpp"
 #include "matrix.hpp"
 
+/*! Sparse operator for tensor-product elements, in which the nonzeros of each row
+ *  lie along a single line (constant i or constant j) of the nPts1D x nPts1D points */
+class lineOper
+{
+public:
+  /*! Extract the line structure from the rows of A (or from its columns if transpose);
+   *  returns false (leaving the operator empty) if A does not have line structure */
+  bool setup(matrix<flt> &A, uint nPts1D, bool transpose = false);
+
+  bool empty(void) {return start.empty();}
+
+  //! Gather along lines: B = A*U, or B += A*U if add
+  void apply(matrix<flt> &U, matrix<flt> &B, bool add);
+
+  //! Scatter along lines for an operator setup from the columns of A: B += A*U
+  void applyTransposePlus(matrix<flt> &U, matrix<flt> &B);
+
+private:
+  vector<int> start;   //! First point along each line
+  vector<int> stride;  //! Stride between points along each line [1 or nPts1D]
+  matrix<flt> wts;  //! Weights along each line
+};
+
 class oper
 {
 public:
@@ -39,49 +64,85 @@ public:
   void setupGradSpts(vector<point> &loc_spts);
 
   //! Setup an interpolation operation between two sets of points using solution basis
-  void setupInterpolate(vector<point> &pts_from, vector<point> &pts_to, matrix<double> &opp_interp);
+  void setupInterpolate(vector<point> &pts_from, vector<point> &pts_to, matrix<flt> &opp_interp);
 
   /*! Setup operator to calculate divergence of correction function at solution points
    *  based upon the normal flux correction at the flux points */
   void setupCorrection(vector<point> &loc_spts, vector<point> &loc_fpts);
 
-  void applyGradSpts(matrix<double> &U_spts, vector<matrix<double> > &dU_spts);
+  void applyGradSpts(matrix<flt> &U_spts, vector<matrix<flt> > &dU_spts);
 
-  void applyGradFSpts(vector<matrix<double>> &F_spts, vector<vector<matrix<double>>> &dF_spts);
+  void applyGradFSpts(vector<matrix<flt>> &F_spts, vector<vector<matrix<flt>>> &dF_spts);
 
-  void applyDivFSpts(vector<matrix<double>> &F_spts, matrix<double> &divF_spts);
+  void applyDivFSpts(vector<matrix<flt>> &F_spts, matrix<flt> &divF_spts);
 
-  void applySptsFpts(matrix<double> &U_spts, matrix<double> &U_fpts);
+  void applySptsFpts(matrix<flt> &U_spts, matrix<flt> &U_fpts);
 
-  void applySptsMpts(matrix<double> &U_spts, matrix<double> &U_mpts);
+  void applySptsMpts(matrix<flt> &U_spts, matrix<flt> &U_mpts);
 
   /*! For the standard FR method: extrapolate the transformed flux to the flux points
    *  and dot with the transformed outward unit normal */
-  void applyExtrapolateFn(vector<matrix<double>> &F_spts, matrix<double> &tnorm_fpts, matrix<double> &Fn_fpts);
+  void applyExtrapolateFn(vector<matrix<flt>> &F_spts, matrix<double> &tnorm_fpts, matrix<flt> &Fn_fpts);
 
   /*! For the modified space-time transformation method: Extrapolate the physical flux
    *  to the flux points and dott with the physical outward unit normal */
-  void applyExtrapolateFn(vector<matrix<double>> &F_spts, matrix<double> &norm_fpts, matrix<double> &Fn_fpts, vector<double> &dA_fpts);
+  void applyExtrapolateFn(vector<matrix<flt>> &F_spts, matrix<double> &norm_fpts, matrix<flt> &Fn_fpts, vector<double> &dA_fpts);
+
+  void applyCorrectDivF(matrix<flt> &dFn_fpts, matrix<flt> &divF_spts);
 
-  void applyCorrectDivF(matrix<double> &dFn_fpts, matrix<double> &divF_spts);
+  //! Get the list of kernels available for the given operator [OPER_TYPE]
+  vector<int> getKernels(int operType);
 
-  const matrix<double>& get_oper_div_spts();
-  const matrix<double>& get_oper_spts_fpts();
+  //! Get the kernel currently used for the given operator
+  int getKernel(int operType) {return kernels[operType];}
 
-  map<int,matrix<double>*> get_oper_grad_spts;
-  map<int,matrix<double>*> get_oper_correct;
+  //! Select the kernel to use for the given operator
+  void setKernel(int operType, int kernel);
+
+  const matrix<flt>& get_oper_div_spts();
+  const matrix<flt>& get_oper_spts_fpts();
+  const matrix<flt>& get_oper_grad_spts(int dim);
+  const matrix<flt>& get_oper_correction();
 
 private:
   geo *Geo;
   input *params;
   uint nDims, nFields, eType, order;
 
-  matrix<double> opp_spts_to_fpts;
-  matrix<double> opp_spts_to_mpts;
-  vector<matrix<double>> opp_grad_spts;
-  matrix<double> opp_div_spts;
-  matrix<double> opp_correction;
+  matrix<flt> opp_spts_to_fpts;
+  matrix<flt> opp_spts_to_mpts;
+  vector<matrix<flt>> opp_grad_spts;
+  matrix<flt> opp_div_spts;
+  matrix<flt> opp_correction;
+
+  /* --- Structured forms of the operators, detected at setup [unless denseOperators] --- */
+  vector<int> sptsFptsIdx;  //! If opp_spts_to_fpts is a pure injection (e.g. Lobatto spts): spt of each fpt [empty otherwise]
+  vector<int> sptsMptsIdx;  //! If opp_spts_to_mpts is a pure injection: spt of each mesh point [empty otherwise]
+  lineOper sptsFptsLines;   //! Line form of opp_spts_to_fpts: each fpt depends on one line of spts
+  vector<lineOper> gradLines;  //! Line form of opp_grad_spts: d/dxi & d/deta act along lines of spts
+  lineOper corrLines;       //! Line form of opp_correction: each fpt corrects one line of spts
+  const genKernelSet* genSet = NULL;  //! Generated kernels for this element type, order & scheme [if built]
+
+  //! Kernel used to apply each operator [OPER_KERNEL], indexed by OPER_TYPE
+  array<int,3> kernels;
+
+  //! Extrapolate F_spts[dim] to the flux points, using the fastest available form of opp_spts_to_fpts
+  void extrapolateSptsFpts(matrix<flt> &F_spts, matrix<flt> &F_fpts);
+
+  //! Detect injection & sparse structure in the operators & setup their compact forms
+  void setupOperatorStructure(void);
+
+  //! Find the generated kernels matching this operator (if any) & verify them against the matrices
+  void setupGenKernels(void);
+
+  /* --- On-disk operator cache --- */
+
+  //! Name of the cache file for this element type, order, point type & correction scheme
+  string getCacheFileName(void);
+
+  //! Write all operator matrices to a binary cache file
+  void writeCache(string fileName);
 
-  /*! Evaluate the divergence of the (VCJH) correction function at a solution point from a flux point */
-  double divVCJH_quad(int in_fpt, vector<double> &loc, vector<double> &loc_1d_spts, uint vcjh, uint order);
+  //! Read all operator matrices from a cache file; returns false if missing or incompatible
+  bool readCache(string fileName);
 };
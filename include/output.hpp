@@ -28,5 +28,9 @@ void writeCSV(solver *Solver, input *params);
 /*! Write solution data to a Paraview .vtu file. */
 void writeParaview(solver *Solver, input *params);
 
-/*! Compute the residual and print to the screen. */
-void writeResidual(solver *Solver, input *params);
+/*! Print the L2 & L-infinity differences in the primitives at the solution points from the
+ *  reference CSV solution params->refSolutionFile (written on the same mesh & order) */
+void compareSolution(solver *Solver, input *params);
+
+/*! Compute the residual and print to the screen; returns the residual norm of each field. */
+vector<double> writeResidual(solver *Solver, input *params);
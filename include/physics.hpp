@@ -0,0 +1,163 @@
+/*!
+ * \file physics.hpp
+ * \brief Compile-time physics policies for the solver's pointwise flux kernels
+ *
+ * Each policy fixes the equation set, nFields & nDims at compile time, so that the
+ * loops in the flux, Riemann-solve & time-update kernels templated on it have
+ * constant trip counts & no per-point branching on params->equation.  These are
+ * the solver's only inviscid flux, Rusanov & Lax-Friedrichs routines; the Roe flux
+ * & low-Mach dissipation are shared pointwise routines in flux.cpp.
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 0.0.1
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2014 Jacob Crabill.
+ *
+ */
+#pragma once
+
+#include <cmath>
+
+#include "global.hpp"
+
+#include "flux.hpp"
+#include "input.hpp"
+
+/*! Scalar linear advection [diffusion not yet implemented] */
+struct AdvectionDiffusion
+{
+  static const int nFields = 1;
+  static const int nDims = 2;
+
+  //! The exterior state at all boundaries is held at zero [no ghost-state BCs]
+  static const bool ghostStateBCs = false;
+
+  //! Low-Mach preconditioning does not apply [rejected at input]
+  static const bool lowMachPrecon = false;
+
+  //! Inviscid flux vector F[dim][field] at a point
+  static inline void inviscidFlux(const double* U, double F[nDims][nFields], input *params)
+  {
+    F[0][0] = params->advectVx*U[0];
+    F[1][0] = params->advectVy*U[0];
+  }
+
+  //! Common normal flux at an interior face [Lax-Friedrichs]
+  static inline void interfaceFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
+  {
+    double uAvg = 0.5*(uL[0] + uR[0]);
+    double uDiff = uL[0] - uR[0];
+    double vNorm = params->advectVx*norm[0] + params->advectVy*norm[1];
+
+    Fn[0] = vNorm*uAvg + 0.5*params->lambda*abs(vNorm)*uDiff;
+  }
+
+  //! Common normal flux at a boundary face, given the ghost state uR [central]
+  static inline void boundaryFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
+  {
+    Fn[0] = params->advectVx*0.5*norm[0]*(uL[0]+uR[0])
+          + params->advectVy*0.5*norm[1]*(uL[0]+uR[0]);
+  }
+};
+
+/*! 2D compressible Euler equations */
+struct Euler2D
+{
+  static const int nFields = 4;
+  static const int nDims = 2;
+
+  //! Boundary conditions set the ghost state seen by the Riemann solver [bound::applyBC]
+  static const bool ghostStateBCs = true;
+
+  //! Low-Mach preconditioning of the residual & dissipation [params->lowMachPrecon]
+  static const bool lowMachPrecon = true;
+
+  //! Inviscid flux vector F[dim][field] at a point
+  static inline void inviscidFlux(const double* U, double F[nDims][nFields], input *params)
+  {
+    double rho = U[0];
+    double u = U[1]/rho;
+    double v = U[2]/rho;
+    double p = (params->gamma-1.0)*(U[3]-(0.5*rho*((u*u)+(v*v))));
+
+    F[0][0] =  U[1];       F[1][0] =  U[2];
+    F[0][1] =  U[1]*u+p;   F[1][1] =  U[1]*v;
+    F[0][2] =  U[2]*u;     F[1][2] =  U[2]*v+p;
+    F[0][3] = (U[3]+p)*u;  F[1][3] = (U[3]+p)*v;
+  }
+
+  //! Common normal flux at an interior face [Rusanov or Roe, from params->riemann_type]
+  static inline void interfaceFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
+  {
+    if (params->riemann_type == 1) {
+      roeFlux(uL, uR, norm, Fn, params);
+      return;
+    }
+
+    double FL[nDims][nFields], FR[nDims][nFields];
+    inviscidFlux(uL, FL, params);
+    inviscidFlux(uR, FR, params);
+
+    double rhoL = uL[0];     double rhoR = uR[0];
+    double vxL = uL[1]/rhoL; double vxR = uR[1]/rhoR;
+    double vyL = uL[2]/rhoL; double vyR = uR[2]/rhoR;
+
+    // Pressure for the wave-speed estimate [long-standing form, without the 0.5 on the
+    // kinetic energy; kept so that existing results are reproduced]
+    double pL = (params->gamma-1.0)*(uL[3]-rhoL*(vxL*vxL+vyL*vyL));
+    double pR = (params->gamma-1.0)*(uR[3]-rhoR*(vxR*vxR+vyR*vyR));
+
+    double vnL = 0.0, vnR = 0.0;
+    double FnL[nFields] = {}, FnR[nFields] = {};
+    for (int j=0; j<nDims; j++) {
+      vnL += norm[j]*uL[j+1]/rhoL;
+      vnR += norm[j]*uR[j+1]/rhoR;
+      for (int i=0; i<nFields; i++) {
+        FnL[i] += norm[j]*FL[j][i];
+        FnR[i] += norm[j]*FR[j][i];
+      }
+    }
+
+    if (params->lowMachPrecon) {
+      // Preconditioned scalar dissipation, evaluated at the arithmetic-average state
+      double diss[nFields], dU[nFields];
+      for (int i=0; i<nFields; i++)
+        dU[i] = uR[i]-uL[i];
+      double pAvg = 0.5*(params->gamma-1.0)*(uL[3]+uR[3] - 0.5*rhoL*(vxL*vxL+vyL*vyL) - 0.5*rhoR*(vxR*vxR+vyR*vyR));
+      lowMachDissipation(0.5*(rhoL+rhoR),0.5*(vxL+vxR),0.5*(vyL+vyR),pAvg,0.5*(vnL+vnR),dU,diss,params);
+      for (int i=0; i<nFields; i++)
+        Fn[i] = 0.5*(FnL[i]+FnR[i] - diss[i]);
+      return;
+    }
+
+    double csqL = max(params->gamma*pL/rhoL,0.0);
+    double csqR = max(params->gamma*pR/rhoR,0.0);
+    double eig = max(fabs(vnL) + sqrt(csqL), fabs(vnR) + sqrt(csqR));
+
+    for (int i=0; i<nFields; i++)
+      Fn[i] = 0.5*(FnL[i]+FnR[i] - eig*(uR[i]-uL[i]));
+  }
+
+  //! Common normal flux at a boundary face, given the ghost state uR [central or Roe]
+  static inline void boundaryFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
+  {
+    if (params->riemann_type == 1) {
+      roeFlux(uL, uR, norm, Fn, params);
+      return;
+    }
+
+    double FL[nDims][nFields], FR[nDims][nFields];
+    inviscidFlux(uL, FL, params);
+    inviscidFlux(uR, FR, params);
+
+    for (int i=0; i<nFields; i++) {
+      Fn[i] = 0;
+      for (int j=0; j<nDims; j++)
+        Fn[i] += 0.5*(FL[j][i]+FR[j][i])*norm[j];
+    }
+  }
+};
@@ -24,6 +24,21 @@ double dLagrange(vector<double> &x_lag, double y, uint mode);
 /*! Evaluate the second derivative of the 1D Lagrange polynomial mode based on points x_lag at point y */
 double ddLagrange(vector<double> &x_lag, double y, uint mode);
 
+/*! Get the barycentric weights for Lagrange interpolation through the points x_lag */
+vector<double> getBarycentricWeights(vector<double> &x_lag);
+
+/*! Evaluate all 1D Lagrange polynomials based on points x_lag (with barycentric weights w) at point y */
+void LagrangeBasis(vector<double> &x_lag, vector<double> &w, double y, double* out);
+
+/*! Evaluate the first derivative of all 1D Lagrange polynomials based on points x_lag (with barycentric weights w) at point y */
+void dLagrangeBasis(vector<double> &x_lag, vector<double> &w, double y, double* out);
+
+/*! Get the locations of the nPts Gauss-Legendre points on [-1,1] (Newton iteration on P_nPts) */
+vector<double> getGaussLegendrePts(int nPts);
+
+/*! Get the locations of the nPts Gauss-Lobatto points on [-1,1] (Newton iteration on (1-x^2)P'_(nPts-1)) */
+vector<double> getGaussLobattoPts(int nPts);
+
 double Legendre(double in_r, int in_mode);
 
 double dLegendre(double in_r, int in_mode);
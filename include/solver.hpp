@@ -58,6 +58,9 @@ public:
   //! Setup the FR operators for all ele types and polynomial orders which will be used in computation
   void setupOperators();
 
+  //! Sort the boundary faces into contiguous groups by BC type & precompute the BC reference states
+  void setupBoundGroups(void);
+
   /* === Functions Related to Basic FR Process === */
 
   //! Apply the initial condition to all elements
@@ -65,12 +68,25 @@ public:
 
   void update(void);
 
+  //! Advance the solution through one full explicit Runge-Kutta step
+  void updateRK(void);
+
+  //! updateRK() specialized on the physics policy [see physics.hpp]
+  template<class Physics>
+  void updateRK(void);
+
+  //! Advance one physical time step with BDF2 dual time stepping (RK as pseudo-time smoother)
+  void updateDualTime(void);
+
   //! Perform one full step of computation
+  template<class Physics>
   void calcResidual(int step);
 
   //! Advance solution in time
+  template<class Physics>
   void timeStepA(int step);
 
+  template<class Physics>
   void timeStepB(int step);
 
   void copyUspts_U0(void);
@@ -83,12 +99,19 @@ public:
   void extrapolateUMpts(void);
 
   //! Calculate the inviscid flux at the solution points
+  template<class Physics>
   void calcInviscidFlux_spts(void);
 
   //! Calculate the inviscid interface flux at all element faces
+  template<class Physics>
   void calcInviscidFlux_faces(void);
 
+  //! [Structured mesh] Calculate the inviscid interface flux by sweeping i- & j-lines of cells
+  template<class Physics>
+  void calcInviscidFlux_structured(void);
+
   //! Calculate the inviscid interface flux at all boundary faces
+  template<class Physics>
   void calcInviscidFlux_bounds(void);
 
   //! Calculate the gradient of the solution at the solution points
@@ -130,6 +153,30 @@ public:
 
   void moveMesh(int step);
 
+  /*! Apply the low-Mach preconditioner to divF_spts (pseudo-time update) */
+  template<class Physics>
+  void preconditionResidual(int step);
+
+  /*! Apply implicit residual smoothing to divF_spts: a few Jacobi sweeps on
+   *  (1 + eps*nNbs)*Rs_p - eps*sum(Rs_nb) = R_p over all solution points, where the neighbors
+   *  of a point are its tensor-product neighbors in the element & the facing point across a face */
+  void smoothResidual(int step);
+
+  //! Get the norm (of type normType) of the residual over all elements, before any smoothing / preconditioning
+  vector<double> getResidualNorm(int normType);
+
+  /*! Track the residual history; return true once the simulation has converged
+   *  (residual dropped by params->convResDrop, or stagnated over params->convStagWindow) */
+  bool checkConvergence(vector<double> &res);
+
+  /* === Functions Related to p-Sequencing === */
+
+  //! Elevate the polynomial order once the residual has dropped by params->pSeqResDrop
+  void checkOrderElevation(vector<double> &res);
+
+  //! Re-setup all elements & operators at a new order, interpolating the current solution
+  void changeOrder(int newOrder);
+
   // **All of the following functions are just food for thought at the moment**
 
   /* === Functions for Shock Capturing & Filtering=== */
@@ -167,5 +214,63 @@ private:
 
   int nRKSteps;
 
+  //! BC type & first index in bounds of each group of boundary faces [bcGroupStart has nGroups+1 entries]
+  vector<int> bcGroupType, bcGroupStart;
+
+  //! Freestream & other BC reference values
+  bcState bcRef;
+
+  //! Physics-specialized updateRK<>(), selected once in setup() from params->equation
+  void (solver::*updateRKPhysics)(void) = NULL;
+
   vector<double> RKa, RKb;
+
+  //! # of physical time steps taken with dual time stepping (BDF1 used for the first step)
+  int nDualSteps = 0;
+
+  //! Offset of each element's solution points in the global residual-smoothing arrays
+  vector<int> sptStart;
+
+  //! Point-to-point connectivity for residual smoothing [CSR: neighbors of p are smoothNbs[smoothNbStart[p]:smoothNbStart[p+1]]]
+  vector<int> smoothNbStart, smoothNbs;
+
+  //! Unsmoothed, current & previous-sweep physical residuals at all solution points for residual smoothing
+  matrix<double> resSmooth0, resSmoothNew, resSmoothOld;
+
+  //! Build the point-to-point connectivity for residual smoothing [needs Geo->c2e, so called before releaseSetupData]
+  void setupResidualSmoothing(void);
+
+  //! Norm of the first-stage residual, taken before it is smoothed / preconditioned in place
+  vector<double> resNorm;
+
+  //! Store resNorm from the current first-stage residual [if it will be modified in place]
+  void storeResidualNorm(void);
+
+  //! Compute the norm (of type normType) of the residual currently in divF_spts[0]
+  vector<double> calcResidualNorm(int normType);
+
+  //! Peak residual & history of the max (over fields) residual relative to it, for the convergence monitor
+  vector<double> convResPeak;
+  vector<double> convResHist;
+
+  //! Peak residual seen at the current p-sequencing level
+  vector<double> pSeqResPeak;
+
+  //! For p-sequencing, set the time step for the current polynomial order
+  void setPSeqTimeStep(void);
+
+  /*! Time each available kernel for each operator of the given element type & order on the
+   *  current elements, and select the fastest; choices are cached in params->autotuneFile */
+  void autotuneOperators(int eType, int order);
+
+  //! [Lean-memory mode] Release mesh connectivity & setup-only element data, and report the savings
+  void releaseSetupData(void);
+
+  //! Report the storage held by the elements, per element & by category
+  void reportMemory(void);
+
+  /*! [Structured mesh] Common inviscid flux between face locFL of eL & face locFR of eR
+   *  (eR's flux points are traversed in reverse to match eL's) */
+  template<class Physics>
+  void calcStructuredFaceFlux(ele &eL, ele &eR, int locFL, int locFR);
 };
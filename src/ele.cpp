@@ -20,6 +20,7 @@
 
 #include "../include/polynomials.hpp"
 #include "../include/flux.hpp"
+#include "../include/physics.hpp"
 
 using namespace std;
 
@@ -91,6 +92,31 @@ void ele::initialize(void)
   }
 }
 
+//! Release a vector of matrices; returns the # of bytes released
+template<typename T>
+static size_t freeMatrices(vector<matrix<T>> &mats)
+{
+  size_t bytes = 0;
+  for (auto& m:mats) bytes += m.getMemSize();
+  return bytes + freeVector(mats);
+}
+
+//! # of bytes held by a vector
+template<typename T>
+static size_t vectorMemSize(const vector<T> &vec)
+{
+  return vec.capacity()*sizeof(T);
+}
+
+//! # of bytes held by a vector of matrices
+template<typename T>
+static size_t matricesMemSize(const vector<matrix<T>> &mats)
+{
+  size_t bytes = vectorMemSize(mats);
+  for (auto& m:mats) bytes += m.getMemSize();
+  return bytes;
+}
+
 void ele::setup(input *inParams, geo *inGeo)
 {
   /* --- Basic Stuff --- */
@@ -115,10 +141,10 @@ void ele::setup(input *inParams, geo *inGeo)
     nFields = nDims + 2;
   }
 
-  /* --- Setup all data arrays --- */
+  /* --- Setup all data arrays [only those used by the active viscous / motion /
+   * dual-time options are allocated] --- */
   U_spts.setup(nSpts,nFields);
   U_fpts.setup(nFpts,nFields);
-  U_mpts.setup(nNodes,nFields);
   Fn_fpts.setup(nFpts,nFields);
   dFn_fpts.setup(nFpts,nFields);
 
@@ -135,25 +161,32 @@ void ele::setup(input *inParams, geo *inGeo)
   divF_spts.resize(nRKSteps);
   for (auto& dF:divF_spts) dF.setup(nSpts,nFields);
 
-
-  dU_spts.resize(nDims);
-  dU_fpts.resize(nDims);
-  for (int dim=0; dim<nDims; dim++) {
-    dU_spts[dim].setup(nSpts,nFields);
-    dU_fpts[dim].setup(nFpts,nFields);
+  if (params->dualTime) {
+    Un.setup(nSpts,nFields);
+    Unm1.setup(nSpts,nFields);
   }
 
+
   F_spts.resize(nDims);
-  F_fpts.resize(nDims);
-  dF_spts.resize(nDims);
-  tdF_spts.resize(nDims);
-  for (int i=0; i<nDims; i++) {
-    F_spts[i].setup(nSpts,nFields);
-    F_fpts[i].setup(nFpts,nFields);
-    dF_spts[i].resize(nDims);
-    tdF_spts[i].setup(nSpts,nFields);
-    for (int j=0; j<nDims; j++) {
-      dF_spts[i][j].setup(nSpts,nFields);
+  for (auto& F:F_spts) F.setup(nSpts,nFields);
+
+  // Solution gradient: viscous flux, or the grid-velocity term of the moving-mesh divergence
+  if (params->viscous || params->motion) {
+    dU_spts.resize(nDims);
+    for (auto& dU:dU_spts) dU.setup(nSpts,nFields);
+  }
+
+  if (params->viscous) {
+    dU_fpts.resize(nDims);
+    for (auto& dU:dU_fpts) dU.setup(nFpts,nFields);
+  }
+
+  // Physical-space flux gradient: moving-mesh divergence only
+  if (params->motion) {
+    dF_spts.resize(nDims);
+    for (auto& dF:dF_spts) {
+      dF.resize(nDims);
+      for (auto& dFi:dF) dFi.setup(nSpts,nFields);
     }
   }
 
@@ -161,23 +194,21 @@ void ele::setup(input *inParams, geo *inGeo)
   detJac_fpts.resize(nFpts);
   Jac_spts.resize(nSpts);
   Jac_fpts.resize(nFpts);
-  JGinv_spts.resize(nSpts);
   for (auto& spt:Jac_spts) spt.setup(nDims,nDims);
   for (auto& fpt:Jac_fpts) fpt.setup(nDims,nDims);
-  for (auto& spt:JGinv_spts) spt.setup(nDims,nDims);
 
   norm_fpts.setup(nFpts,nDims);
   tNorm_fpts.setup(nFpts,nDims);
   dA_fpts.resize(nFpts);
 
-  gridVel_nodes.setup(nNodes,nDims);
-  gridVel_spts.setup(nSpts,nDims);
-  gridVel_fpts.setup(nFpts,nDims);
-  gridVel_nodes.initializeToZero();
-  gridVel_spts.initializeToZero();
-  gridVel_fpts.initializeToZero();
-
   if (params->motion != 0) {
+    gridVel_nodes.setup(nNodes,nDims);
+    gridVel_spts.setup(nSpts,nDims);
+    gridVel_fpts.setup(nFpts,nDims);
+    gridVel_nodes.initializeToZero();
+    gridVel_spts.initializeToZero();
+    gridVel_fpts.initializeToZero();
+
     nodesRK.resize(nRKSteps);
     for (auto &vec:nodesRK) {
       vec = nodes;
@@ -198,6 +229,65 @@ void ele::setup(input *inParams, geo *inGeo)
   calcPosSpts();
   calcPosFpts();
   setPpts();
+
+  if (!params->motion) {
+    // Static mesh: the shape bases & Jacobians were only needed to set the transforms
+    freeMatrices(Jac_spts);
+    freeMatrices(Jac_fpts);
+    freeMatrices(dShape_spts);
+    freeMatrices(dShape_fpts);
+    shape_spts.clear();
+    shape_fpts.clear();
+  }
+}
+
+size_t ele::releaseSetupData(void)
+{
+  size_t bytes = 0;
+
+  // Global mesh IDs; only used while setting up the faces
+  bytes += freeVector(nodeID);
+  bytes += freeVector(faceID);
+  bytes += freeVector(bndFace);
+
+  if (!params->motion) {
+    // Static mesh: the reference-domain points are only needed to set the transforms
+    bytes += freeVector(loc_spts);
+    bytes += freeVector(loc_fpts);
+  }
+
+  return bytes;
+}
+
+eleMemUsage ele::getMemUsage(void)
+{
+  eleMemUsage mem;
+
+  mem.solution = U_spts.getMemSize() + U_fpts.getMemSize() + U_mpts.getMemSize()
+      + U0.getMemSize() + Un.getMemSize() + Unm1.getMemSize();
+
+  mem.flux = matricesMemSize(F_spts) + Fn_fpts.getMemSize() + dFn_fpts.getMemSize()
+      + matricesMemSize(divF_spts);
+
+  mem.gradients = matricesMemSize(dU_spts) + matricesMemSize(dU_fpts) + vectorMemSize(dF_spts);
+  for (auto& dF:dF_spts) mem.gradients += matricesMemSize(dF);
+
+  mem.geometry = vectorMemSize(detJac_spts) + vectorMemSize(detJac_fpts)
+      + matricesMemSize(Jac_spts) + matricesMemSize(Jac_fpts) + JGinv_spts.getMemSize()
+      + norm_fpts.getMemSize() + tNorm_fpts.getMemSize() + vectorMemSize(dA_fpts)
+      + vectorMemSize(loc_spts) + vectorMemSize(loc_fpts) + vectorMemSize(nodes)
+      + vectorMemSize(pos_spts) + vectorMemSize(pos_fpts) + vectorMemSize(pos_ppts);
+
+  mem.motion = shape_spts.getMemSize() + shape_fpts.getMemSize()
+      + matricesMemSize(dShape_spts) + matricesMemSize(dShape_fpts)
+      + gridVel_spts.getMemSize() + gridVel_fpts.getMemSize() + gridVel_nodes.getMemSize()
+      + vectorMemSize(nodesRK);
+  for (auto& nRK:nodesRK) mem.motion += vectorMemSize(nRK);
+
+  mem.other = vectorMemSize(nodeID) + vectorMemSize(faceID) + (bndFace.capacity()+7)/8
+      + tempF.getMemSize() + vectorMemSize(tempU);
+
+  return mem;
 }
 
 void ele::move(int step)
@@ -382,9 +472,6 @@ void ele::calcTransforms(void)
     if (nDims==2) {
       // Determinant of transformation matrix
       detJac_spts[spt] = Jac_spts[spt][0][0]*Jac_spts[spt][1][1]-Jac_spts[spt][1][0]*Jac_spts[spt][0][1];
-      // Inverse of transformation matrix (times its determinant)
-      JGinv_spts[spt][0][0] = Jac_spts[spt][1][1];  JGinv_spts[spt][0][1] =-Jac_spts[spt][0][1];
-      JGinv_spts[spt][1][0] =-Jac_spts[spt][1][0];  JGinv_spts[spt][1][1] = Jac_spts[spt][0][0];
     }
     if (detJac_spts[spt]<0) FatalError("Negative Jacobian at solution points.");
   }
@@ -418,6 +505,50 @@ void ele::calcTransforms(void)
     for (int dim=0; dim<nDims; dim++)
       norm_fpts[fpt][dim] /= dA_fpts[fpt];
   }
+
+  /* --- Affine element [linear tri / parallelogram quad] on a static mesh: the metric
+   * is constant, so store a single copy of it --- */
+  constMetric = (!params->motion && isMetricConstant());
+
+  int nMetric = (constMetric) ? 1 : nSpts;
+  JGinv_spts.setup(nDims*nDims,nMetric);
+  if (nDims==2) {
+    // Inverse of transformation matrix (times its determinant)
+    for (int spt=0; spt<nMetric; spt++) {
+      JGinv_spts(0,spt) = Jac_spts[spt][1][1];  JGinv_spts(1,spt) =-Jac_spts[spt][0][1];
+      JGinv_spts(2,spt) =-Jac_spts[spt][1][0];  JGinv_spts(3,spt) = Jac_spts[spt][0][0];
+    }
+  }
+
+  if (constMetric) {
+    // The per-point Jacobians are no longer needed
+    Jac_spts.resize(1);
+    Jac_fpts.resize(1);
+    Jac_spts.shrink_to_fit();
+    Jac_fpts.shrink_to_fit();
+  }
+}
+
+bool ele::isMetricConstant(void)
+{
+  // Relative tolerance on the Jacobian entries, scaled by the element size
+  double tol = 0;
+  for (int i=0; i<nDims; i++)
+    for (int j=0; j<nDims; j++)
+      tol = max(tol,fabs(Jac_spts[0](i,j)));
+  tol *= 1e-12;
+
+  for (int spt=1; spt<nSpts; spt++)
+    for (int i=0; i<nDims; i++)
+      for (int j=0; j<nDims; j++)
+        if (fabs(Jac_spts[spt](i,j) - Jac_spts[0](i,j)) > tol) return false;
+
+  for (int fpt=0; fpt<nFpts; fpt++)
+    for (int i=0; i<nDims; i++)
+      for (int j=0; j<nDims; j++)
+        if (fabs(Jac_fpts[fpt](i,j) - Jac_spts[0](i,j)) > tol) return false;
+
+  return true;
 }
 
 void ele::updateTransforms(void)
@@ -438,8 +569,8 @@ void ele::updateTransforms(void)
       // Determinant of transformation matrix
       detJac_spts[spt] = Jac_spts[spt][0][0]*Jac_spts[spt][1][1]-Jac_spts[spt][1][0]*Jac_spts[spt][0][1];
       // Inverse of transformation matrix (times its determinant)
-      JGinv_spts[spt][0][0] = Jac_spts[spt][1][1];  JGinv_spts[spt][0][1] =-Jac_spts[spt][0][1];
-      JGinv_spts[spt][1][0] =-Jac_spts[spt][1][0];  JGinv_spts[spt][1][1] = Jac_spts[spt][0][0];
+      JGinv_spts(0,spt) = Jac_spts[spt][1][1];  JGinv_spts(1,spt) =-Jac_spts[spt][0][1];
+      JGinv_spts(2,spt) =-Jac_spts[spt][1][0];  JGinv_spts(3,spt) = Jac_spts[spt][0][0];
     }
     if (detJac_spts[spt]<0) FatalError("Negative Jacobian at solution points.");
   }
@@ -608,35 +739,72 @@ void ele::getShape(point loc, vector<double> &shape)
   }
 }
 
-void ele::calcInviscidFlux_spts()
+/*! Fused pointwise inviscid flux & reference-space transform over n points.
+ *  U & F0/F1 are [n x nFields] row-major; JG holds the SoA metric terms, entry (i,j)
+ *  of all n points in row i*nDims+j, or of the whole element if constMetric [NULL: no
+ *  transform].  Call-free, with restrict arguments, so that the loop over the points
+ *  vectorizes */
+template<class Physics, bool constMetric>
+static void inviscidFluxKernel(const flt* __restrict__ U, flt* __restrict__ F0, flt* __restrict__ F1,
+                               const double* __restrict__ JG, int n, input *params)
 {
-  for (int spt=0; spt<nSpts; spt++) {
+  const int nF = Physics::nFields;
+  const int nD = Physics::nDims;
+  static_assert(nD == 2, "inviscidFluxKernel: 2D physics only");
 
-    inviscidFlux(U_spts[spt], tempF, params);
+  if (JG == NULL) {
+    for (int spt=0; spt<n; spt++) {
+      double u[nF], F[nD][nF];
+      for (int k=0; k<nF; k++)
+        u[k] = U[spt*nF+k];
 
-    if (params->motion) {
-      /* --- Don't transform yet; that will be handled later --- */
-      for (int i=0; i<nDims; i++) {
-        for (int k=0; k<nFields; k++) {
-          F_spts[i][spt][k] = tempF[i][k];
-        }
+      Physics::inviscidFlux(u, F, params);
+
+      for (int k=0; k<nF; k++) {
+        F0[spt*nF+k] = F[0][k];
+        F1[spt*nF+k] = F[1][k];
       }
     }
-    else {
-      /* --- Transform back to reference domain --- */
-      for (int i=0; i<nDims; i++) {
-        for (int k=0; k<nFields; k++) {
-          F_spts[i][spt][k] = 0.;
-          for (int j=0; j<nDims; j++) {
-            F_spts[i][spt][k] += JGinv_spts[spt][i][j]*tempF[j][k];
+  }
+  else {
+    for (int spt=0; spt<n; spt++) {
+      double u[nF], F[nD][nF];
+      for (int k=0; k<nF; k++)
+        u[k] = U[spt*nF+k];
+
+      Physics::inviscidFlux(u, F, params);
+
+      for (int k=0; k<nF; k++) {
+        double Fk0 = 0., Fk1 = 0.;
+        for (int j=0; j<nD; j++) {
+          if (constMetric) {
+            Fk0 += JG[0*nD+j]*F[j][k];
+            Fk1 += JG[1*nD+j]*F[j][k];
+          }
+          else {
+            Fk0 += JG[(0*nD+j)*n+spt]*F[j][k];
+            Fk1 += JG[(1*nD+j)*n+spt]*F[j][k];
           }
         }
+        F0[spt*nF+k] = Fk0;
+        F1[spt*nF+k] = Fk1;
       }
     }
-
   }
 }
 
+template<class Physics>
+void ele::calcInviscidFlux_spts(void)
+{
+  // With a moving mesh, don't transform yet; that will be handled later
+  const double* JG = (params->motion) ? NULL : JGinv_spts[0];
+
+  if (constMetric)
+    inviscidFluxKernel<Physics,true>(U_spts[0], F_spts[0][0], F_spts[1][0], JG, nSpts, params);
+  else
+    inviscidFluxKernel<Physics,false>(U_spts[0], F_spts[0][0], F_spts[1][0], JG, nSpts, params);
+}
+
 void ele::calcViscousFlux_spts()
 {
   for (int spt=0; spt<nSpts; spt++) {
@@ -648,13 +816,13 @@ void ele::calcViscousFlux_spts()
         tempDU(dim,k) = dU_spts[dim](spt,k);
       }
     }
-    viscousFlux(U_spts[spt], tempDU, tempF, params);
+    viscousFlux(getDouble(U_spts[spt],nFields,tempU.data()), tempDU, tempF, params);
 
     /* --- Transform back to reference domain --- */
     for (int k=0; k<nFields; k++) {
       for (int i=0; i<nDims; i++) {
         for (int j=0; j<nDims; j++) {
-          F_spts[i][spt][k] += JGinv_spts[spt][i][j]*tempF[j][k];
+          F_spts[i][spt][k] += JGinv_spts(i*nDims+j,(constMetric) ? 0 : spt)*tempF[j][k];
         }
       }
     }
@@ -676,24 +844,120 @@ void ele::transformGradF_spts(int step)
   }
 }
 
+template<class Physics>
 void ele::timeStepA(int step, double rkVal)
 {
+  double dt = (params->dualTime) ? dtau : params->dt;
+
   for (int spt=0; spt<nSpts; spt++) {
-    for (int i=0; i<nFields; i++) {
-      U_spts[spt][i] = U0[spt][i] - rkVal * params->dt*divF_spts[step][spt][i]/detJac_spts[spt];
+    flt* U = U_spts[spt];
+    const flt* U0s = U0[spt];
+    const flt* divF = divF_spts[step][spt];
+    for (int i=0; i<Physics::nFields; i++) {
+      U[i] = U0s[i] - rkVal * dt*divF[i]/detJac_spts[spt];
     }
   }
 }
 
+template<class Physics>
 void ele::timeStepB(int step, double rkVal)
 {
+  double dt = (params->dualTime) ? dtau : params->dt;
+
   for (int spt=0; spt<nSpts; spt++) {
-    for (int i=0; i<nFields; i++) {
-      U_spts[spt][i] -= rkVal * params->dt*divF_spts[step][spt][i]/detJac_spts[spt];
+    flt* U = U_spts[spt];
+    const flt* divF = divF_spts[step][spt];
+    for (int i=0; i<Physics::nFields; i++) {
+      U[i] -= rkVal * dt*divF[i]/detJac_spts[spt];
+    }
+  }
+}
+
+void ele::addPhysicalSource(int step, int bdfOrder)
+{
+  if (bdfOrder == 1) {
+    // BDF1: dU/dt = (U - Un) / dt
+    for (int spt=0; spt<nSpts; spt++) {
+      for (int i=0; i<nFields; i++) {
+        divF_spts[step][spt][i] += detJac_spts[spt]*(U_spts[spt][i] - Un[spt][i])/params->dt;
+      }
+    }
+  }
+  else {
+    // BDF2: dU/dt = (3*U - 4*Un + Unm1) / (2*dt)
+    for (int spt=0; spt<nSpts; spt++) {
+      for (int i=0; i<nFields; i++) {
+        divF_spts[step][spt][i] += detJac_spts[spt]*(3.*U_spts[spt][i] - 4.*Un[spt][i] + Unm1[spt][i])/(2.*params->dt);
+      }
     }
   }
 }
 
+void ele::shiftTimeLevels(void)
+{
+  Unm1 = Un;
+  Un = U_spts;
+}
+
+void ele::calcDtau(void)
+{
+  // Max. wave speed over the solution points
+  double waveSp = 0;
+  if (params->equation == ADVECTION_DIFFUSION) {
+    waveSp = sqrt(params->advectVx*params->advectVx + params->advectVy*params->advectVy);
+  }
+  else if (params->equation == NAVIER_STOKES) {
+    for (int spt=0; spt<nSpts; spt++) {
+      double rho = U_spts[spt][0];
+      double u = U_spts[spt][1]/rho;
+      double v = U_spts[spt][2]/rho;
+      double p = (params->gamma-1.0)*(U_spts[spt][3] - 0.5*rho*(u*u+v*v));
+      waveSp = max(waveSp, sqrt(u*u+v*v) + sqrt(max(params->gamma*p/rho,0.)));
+    }
+  }
+
+  // Equivalent element length scale from the element area
+  double refArea = (eType == QUAD) ? 4. : 2.;
+  double detJac = 0;
+  for (int spt=0; spt<nSpts; spt++)
+    detJac += detJac_spts[spt];
+  double h = sqrt(refArea*detJac/nSpts);
+
+  /* Explicit limit CFLtau*h/((2*order+1)*waveSp), with point-implicit treatment of the BDF2
+   * source term; written so that waveSp = 0 (e.g. zero advection velocity) gives dt/1.5 */
+  dtau = 1. / ((2*order+1)*waveSp/(params->CFLtau*h) + 1.5/params->dt);
+}
+
+template<class Physics>
+void ele::preconditionResidual(int step)
+{
+  if (!Physics::lowMachPrecon) return;
+
+  double U[Physics::nFields], R[Physics::nFields];
+  for (int spt=0; spt<nSpts; spt++) {
+    flt* divF = divF_spts[step][spt];
+    for (int i=0; i<Physics::nFields; i++) {
+      U[i] = U_spts(spt,i);
+      R[i] = divF[i];
+    }
+    lowMachPrecondition(U,R,params);
+    for (int i=0; i<Physics::nFields; i++) divF[i] = R[i];
+  }
+}
+
+void ele::getPhysResidual(int step, double* res)
+{
+  for (int spt=0; spt<nSpts; spt++)
+    for (int i=0; i<nFields; i++)
+      res[spt*nFields+i] = divF_spts[step][spt][i]/detJac_spts[spt];
+}
+
+void ele::setPhysResidual(int step, const double* res)
+{
+  for (int spt=0; spt<nSpts; spt++)
+    for (int i=0; i<nFields; i++)
+      divF_spts[step][spt][i] = res[spt*nFields+i]*detJac_spts[spt];
+}
 
 void ele::copyUspts_U0(void)
 {
@@ -851,7 +1115,7 @@ vector<double> ele::getResidual(int normType)
       }
       else if (normType == 3) {
         // Infinity norm
-        res[i] = max(abs(divF_spts[0][spt][i]),res[i]);
+        res[i] = max((double)abs(divF_spts[0][spt][i]),res[i]);
       }
     }
   }
@@ -906,6 +1170,14 @@ void ele::setNFpts(int value)
   nFpts = value;
 }
 
+template void ele::calcInviscidFlux_spts<AdvectionDiffusion>(void);
+template void ele::calcInviscidFlux_spts<Euler2D>(void);
 
+template void ele::timeStepA<AdvectionDiffusion>(int step, double rkVal);
+template void ele::timeStepA<Euler2D>(int step, double rkVal);
 
+template void ele::timeStepB<AdvectionDiffusion>(int step, double rkVal);
+template void ele::timeStepB<Euler2D>(int step, double rkVal);
 
+template void ele::preconditionResidual<AdvectionDiffusion>(int step);
+template void ele::preconditionResidual<Euler2D>(int step);
@@ -16,6 +16,7 @@
 #include "../include/face.hpp"
 
 #include "../include/flux.hpp"
+#include "../include/physics.hpp"
 
 face::face()
 {
@@ -54,8 +55,6 @@ void face::setupFace(ele *eL, ele *eR, int locF_L, int locF_R, int gID)
   UR.resize(nFptsR);
   disFnL.resize(nFptsL);
   disFnR.resize(nFptsR);
-  FL.resize(nFptsL);
-  FR.resize(nFptsR);
   dFnL.resize(nFptsL);
   dFnR.resize(nFptsR);
   Fn.setup(nFptsL,nFields);
@@ -82,11 +81,6 @@ void face::setupFace(ele *eL, ele *eR, int locF_L, int locF_R, int gID)
 //    for (int dim=0; dim<nDims; dim++)
 //      normL[fpt][dim] = (eL->norm_fpts[i][dim]);
 
-    FL[fpt].setup(nDims,nFields);
-    for (int dim=0; dim<nDims; dim++)
-      for (int k=0; k<nFields; k++)
-        FL[fpt][dim][k] = &(eL->F_fpts[dim][i][k]);
-
     fpt++;
   }
 
@@ -103,11 +97,6 @@ void face::setupFace(ele *eL, ele *eR, int locF_L, int locF_R, int gID)
 //    for (int dim=0; dim<nDims; dim++)
 //      normR[fpt][dim] = (eR->norm_fpts[i][dim]);  // change norm to matrix<double*> for future
 
-    FR[fpt].setup(nDims,nFields);
-    for (int dim=0; dim<nDims; dim++)
-      for (int k=0; k<nFields; k++)
-        FR[fpt][dim][k] = &(eR->F_fpts[dim][i][k]);
-
     fpt++;
   }
 
@@ -118,45 +107,44 @@ void face::setupFace(ele *eL, ele *eR, int locF_L, int locF_R, int gID)
   tempUR.resize(nFields);
 }
 
+template<class Physics>
 void face::calcInviscidFlux(void)
 {
+  const int nF = Physics::nFields;
+  double uL[nF], uR[nF];
+
   for (int i=0; i<nFptsL; i++) {
     // Calculate common inviscid flux at flux points
-    if (params->equation == ADVECTION_DIFFUSION) {
-      laxFriedrichsFlux(UL[i], UR[i], normL[i], Fn[i], params);
-    }
-    else if (params->equation == NAVIER_STOKES) {
-      if (params->riemann_type==0) {
-        // Calcualte discontinuous inviscid flux at flux points
-        inviscidFlux(UL[i], tempFL, params);
-        inviscidFlux(UR[i], tempFR, params);
-        rusanovFlux(UL[i], UR[i], tempFL, tempFR, normL[i], Fn[i], params);
-      }
-      else if (params->riemann_type==1) {
-        roeFlux(UL[i], UR[i], normL[i], Fn[i], params);
-      }
-    }
+    // [Riemann solve in double precision, whatever the storage precision]
+    Physics::interfaceFlux(getDouble(UL[i],nF,uL), getDouble(UR[i],nF,uR), normL[i], Fn[i], params);
 
     // Calculate difference between discontinuous & common normal flux, and store in ele
     // (Each ele needs only the difference, not the actual common value, for the correction)
     // Need dAL/R to transform normal flux back to reference space
-    for (int j=0; j<nFields; j++) {
-      dFnL[i][j] =  Fn[i][j]*(*dAL[i]) - disFnL[i][j];
-      dFnR[i][j] = -Fn[i][j]*(*dAR[i]) - disFnR[i][j]; // opposite normal direction
+    double* Fni = Fn[i];
+    for (int j=0; j<nF; j++) {
+      dFnL[i][j] =  Fni[j]*(*dAL[i]) - disFnL[i][j];
+      dFnR[i][j] = -Fni[j]*(*dAR[i]) - disFnR[i][j]; // opposite normal direction
     }
   }
 }
 
+template void face::calcInviscidFlux<AdvectionDiffusion>(void);
+template void face::calcInviscidFlux<Euler2D>(void);
+
 void face::calcViscousFlux(void)
 {
   int i;
 
   for (i=0; i<nFptsL; i++) {
+    double* uL = getDouble(UL[i],nFields,tempUL.data());
+    double* uR = getDouble(UR[i],nFields,tempUR.data());
+
     // Calculate discontinuous viscous flux at flux points
-    viscousFlux(UL[i], *gradUL[i], tempFL, params);
-    viscousFlux(UR[i], *gradUR[i], tempFR, params);
+    viscousFlux(uL, *gradUL[i], tempFL, params);
+    viscousFlux(uR, *gradUR[i], tempFR, params);
 
     // Calculte common viscous flux at flux points
-    ldgFlux(UL[i], UR[i], *gradUL[i], *gradUR[i], Fn[i], params);
+    ldgFlux(uL, uR, *gradUL[i], *gradUR[i], Fn[i], params);
   }
 }
@@ -64,7 +64,18 @@ int main(int argc, char *argv[]) {
 
     Solver.update();
 
-    if ((params.iter)%params.monitor_res_freq == 0 || params.iter==1) writeResidual(&Solver,&params);
+    if ((params.iter)%params.monitor_res_freq == 0 || params.iter==1) {
+      vector<double> res = writeResidual(&Solver,&params);
+
+      /* For p-sequencing, elevate the order once the residual has dropped */
+      if (params.pSeq) Solver.checkOrderElevation(res);
+
+      /* Stop early once converged (or stalled), writing the final solution */
+      if ((params.convResDrop > 0 || params.convStagWindow > 0) && Solver.checkConvergence(res)) {
+        if ((params.iter)%params.plot_freq != 0) writeData(&Solver,&params);
+        break;
+      }
+    }
     if ((params.iter)%params.plot_freq == 0) writeData(&Solver,&params);
 
   }
@@ -74,4 +85,7 @@ int main(int argc, char *argv[]) {
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>( finalTime - initTime ).count();
   double execTime = (double)duration/1000.;
   cout << setprecision(3) << "Execution time = " << execTime << "s" << endl;
+
+  /* Report the difference from a reference solution [e.g. mixed- vs. double-precision builds] */
+  if (!params.refSolutionFile.empty()) compareSolution(&Solver,&params);
 }
@@ -21,29 +21,6 @@
 #include <array>
 #include <vector>
 
-void inviscidFlux(double* U, matrix<double> &F, input *params)
-{
-  /* --- Note: Flux matrix expected to be <nDims x nFields> --- */
-  if (params->equation == ADVECTION_DIFFUSION) {
-    F[0][0] = params->advectVx*U[0];
-    F[1][0] = params->advectVy*U[0];
-  }
-  else if (params->equation == NAVIER_STOKES) {
-    double rho, u, v, p;
-    rho = U[0];
-    u = U[1]/rho;
-    v = U[2]/rho;
-    p = (params->gamma-1.0)*(U[3]-(0.5*rho*((u*u)+(v*v))));
-
-    /* --- Assuming F has already been sized properly... --- */
-    F[0][0] =  U[1];       F[1][0] =  U[2];
-    F[0][1] =  U[1]*u+p;   F[1][1] =  U[1]*v;
-    F[0][2] =  U[2]*u;     F[1][2] =  U[2]*v+p;
-    F[0][3] = (U[3]+p)*u;  F[1][3] = (U[3]+p)*v;
-  }
-}
-
-
 void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *params)
 {
   double rho, u, v, e;
@@ -115,107 +92,62 @@ void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *
   Fvis[1][3] = -(u*tauxy+v*tauyy+(mu/params->prandtl)*(params->gamma)*de_dy);
 }
 
-//void rusanovFlux(vector<double> &UL, vector<double> &UR, vector<vector<double*>> &FL, vector<vector<double*>> &FR, vector<double> &norm, vector<double> &Fn, input *params)
-void rusanovFlux(double* UL, double* UR, matrix<double> &FL, matrix<double> &FR, double* norm, double* Fn, input *params)
-{
-  int i, j;
-  double rhoL, uL, vL, wL, pL, vnL=0.0;
-  double rhoR, uR, vR, wR, pR, vnR=0.0;
-  double csqL, csqR, eigL, eigR, eig;
-
-  double FnL[5] = {0,0,0,0,0};
-  double FnR[5] = {0,0,0,0,0};
-
-  // Get primitive variables
-  rhoL = UL[0];     rhoR = UR[0];
-  uL = UL[1]/rhoL;  uR = UR[1]/rhoR;
-  vL = UL[2]/rhoL;  vR = UR[2]/rhoR;
-
-  // Calculate pressure
-  if (params->nDims==2) {
-    pL = (params->gamma-1.0)*(UL[3]-rhoL*(uL*uL+vL*vL));
-    pR = (params->gamma-1.0)*(UR[3]-rhoR*(uR*uR+vR*vR));
-  }else if (params->nDims==3) {
-    wL = UL[3]/UL[0];   wR = UR[3]/UR[0];
-    pL = (params->gamma-1.0)*(UL[3]-rhoL*(uL*uL+vL*vL+wL*wL));
-    pR = (params->gamma-1.0)*(UR[3]-rhoR*(uR*uR+vR*vR+wR*wR));
-  }
-
-  // Get normal fluxes, normal velocities
-  for (j=0; j<params->nDims; j++) {
-    vnL += norm[j]*UL[j+1]/rhoL;
-    vnR += norm[j]*UR[j+1]/rhoR;
-    for (i=0; i<params->nFields; i++) {
-      FnL[i] += norm[j]*FL[j][i];
-      FnR[i] += norm[j]*FR[j][i];
-    }
-  }
-
-  // Get maximum eigenvalue for diffusion coefficient
-  csqL = max(params->gamma*pL/rhoL,0.0);
-  csqR = max(params->gamma*pR/rhoR,0.0);
-  eigL = fabs(vnL) + sqrt(csqL);
-  eigR = fabs(vnR) + sqrt(csqR);
-  eig = max(eigL,eigR);
-
-  // Calculate Rusanov flux
-  for (i=0; i<params->nFields; i++) {
-    Fn[i] = 0.5*(FnL[i]+FnR[i] - eig*(UR[i]-UL[i]));
-  }
-}
-
-
-void centralFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
-{
-  if (params->equation == ADVECTION_DIFFUSION) {
-    Fn[0] = params->advectVx*0.5*norm[0]*(uL[0]+uR[0])
-          + params->advectVy*0.5*norm[1]*(uL[0]+uR[0]);
-  }
-  else if (params->equation == NAVIER_STOKES) {
-    FatalError("centralFlux not supported for Navier-Stokes simulations.");
-  }
-}
-
-void centralFlux(matrix<double> &FL, matrix<double> &FR, double* norm, double* Fn, input *params)
+/*! Reference velocity for low-Mach preconditioning: the local velocity, bounded below by a
+ *  fraction of the freestream & above by c.  The absolute floor keeps Ur > 0 at stagnation
+ *  points when the freestream is at rest. */
+static double precondRefVelocity(double qsq, double csq, input *params)
 {
-  for (int i=0; i<params->nFields; i++) {
-    Fn[i] = 0;
-    for (int j=0; j<params->nDims; j++) {
-      Fn[i] += 0.5*(FL[j][i]+FR[j][i])*norm[j];
-    }
-  }
+  double c = sqrt(csq);
+  return min(c, max(max(sqrt(qsq), params->precondEps*params->vMagInf), 1e-3*c));
 }
 
-void upwindFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
+void lowMachPrecondition(double* U, double* R, input *params)
 {
-  if (params->equation == ADVECTION_DIFFUSION) {
-    double FL, FR, alpha;
-    alpha = params->advectVx*norm[0]+params->advectVy*norm[1];
-    FL = alpha*uL[0];
-    FR = alpha*uR[0];
-    Fn[0] = 0.5*( FR+FL - alpha*(FR-FL) );
-  }
+  double gamma = params->gamma;
+  double rho = U[0];
+  double u = U[1]/rho;
+  double v = U[2]/rho;
+  double qsq = u*u + v*v;
+  double p = (gamma-1.0)*(U[3] - 0.5*rho*qsq);
+  double csq = gamma*p/rho;
+  double H = (U[3]+p)/rho;
+
+  double Ur = precondRefVelocity(qsq,csq,params);
+  double fac = 1. - Ur*Ur/csq;
+
+  // P*R = R - (1 - Ur^2/c^2) * dU/dp|(u,v,s) * dp(R)
+  double dp = (gamma-1.0)*(R[3] - u*R[1] - v*R[2] + 0.5*qsq*R[0]);
+  dp *= fac/csq;
+
+  R[0] -= dp;
+  R[1] -= dp*u;
+  R[2] -= dp*v;
+  R[3] -= dp*H;
 }
 
-
-void laxFriedrichsFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
+void lowMachDissipation(double rho, double u, double v, double p, double vn, double* dU, double* diss, input *params)
 {
-  if (params->equation == ADVECTION_DIFFUSION) {
-    Fn[0] = params->advectVx*0.5*norm[0]*(uL[0]+uR[0])
-          + params->advectVy*0.5*norm[1]*(uL[0]+uR[0]);
-
-    double uAvg, uDiff, vNorm;
-
-    uAvg = 0.5*(uL[0] + uR[0]);
-    uDiff = uL[0] - uR[0];
-
-    vNorm = params->advectVx*norm[0] + params->advectVy*norm[1];
-
-    Fn[0] = vNorm*uAvg + 0.5*params->lambda*abs(vNorm)*uDiff;
-  }
-  else if (params->equation == NAVIER_STOKES) {
-    FatalError("laxFlux not supported for Navier-Stokes simulations.");
-  }
+  double gamma = params->gamma;
+  double qsq = u*u + v*v;
+  double csq = max(gamma*p/rho,0.0);
+  double H = csq/(gamma-1.0) + 0.5*qsq;
+
+  double Ur = precondRefVelocity(qsq,csq,params);
+  double Ursq = Ur*Ur;
+
+  // Max. eigenvalue of the preconditioned system
+  double alpha = 0.5*(1. - Ursq/csq);
+  double eig = fabs(vn)*(1.-alpha) + sqrt(alpha*alpha*vn*vn + Ursq);
+  eig = max(eig,fabs(vn));
+
+  // P^-1 * dU = dU + (1/Ur^2 - 1/c^2) * dU/dp * dp
+  double dp = (gamma-1.0)*(dU[3] - u*dU[1] - v*dU[2] + 0.5*qsq*dU[0]);
+  dp *= (1./Ursq - 1./csq);
+
+  diss[0] = eig*(dU[0] + dp);
+  diss[1] = eig*(dU[1] + dp*u);
+  diss[2] = eig*(dU[2] + dp*v);
+  diss[3] = eig*(dU[3] + dp*H);
 }
 
 void ldgFlux(double* , double* , matrix<double> &, matrix<double> &, double* , input *)
@@ -303,6 +235,17 @@ void roeFlux(double *uL, double *uR, double* norm, double* Fn, input *params)
     du[i] = uR[i]-uL[i];
   }
 
+  if (params->lowMachPrecon) {
+    // Scalar preconditioned dissipation at the Roe-averaged state
+    double diss[4];
+    double rhom = sq_rho*uL[0];
+    double pm = rhom*am_sq/gamma;
+    lowMachDissipation(rhom,um[0],um[1],pm,unm,du.data(),diss,params);
+    for (int i=0; i<params->nFields; i++)
+      Fn[i] = 0.5*(Fn[i] - diss[i]);
+    return;
+  }
+
   lambda0 = abs(unm-vgn);
   lambdaP = abs(unm-vgn+am);
   lambdaM = abs(unm-vgn-am);
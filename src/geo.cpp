@@ -17,18 +17,57 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <map>
 #include <sstream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//! Hash key for an edge, from its (unordered) pair of corner vertices
+static inline uint64_t edgeKey(int iv1, int iv2)
+{
+  if (iv1 > iv2) std::swap(iv1,iv2);
+  return ((uint64_t)iv1 << 32) | (uint32_t)iv2;
+}
 
 geo::geo()
 {
 
 }
 
+void geo::setupReference(input* params)
+{
+  this->params = params;
+
+  nDims = params->nDims;
+  nFields = params->nFields;
+}
+
 void geo::setup(input* params)
 {
   this->params = params;
 
+  periodicX = periodicY = false;
+  if (params->structuredMesh) {
+    createMesh();
+    setupStructured();
+    return;
+  }
+
+  uint64_t meshHash = 0;
+  if (params->meshCache) {
+    meshHash = getMeshHash();
+    if (readMeshCache(params->meshCacheFile,meshHash)) {
+      cout << "Geo: Read preprocessed mesh from cache file " << params->meshCacheFile << endl;
+      setupNeighbors();
+      return;
+    }
+  }
+
   switch(params->mesh_type) {
     case (READ_MESH):
       readGmsh(params->meshFileName);
@@ -45,36 +84,77 @@ void geo::setup(input* params)
   processConnectivity();
 
   processPeriodicBoundaries();
+
+  if (params->meshCache)
+    writeMeshCache(params->meshCacheFile,meshHash);
+
+  setupNeighbors();
 }
 
 
 void geo::processConnectivity()
 {
   /* --- Setup Edges --- */
-  matrix<int> e2v1;
-  vector<int> edge(2);
-
-  for (int e=0; e<nEles; e++) {
-    for (int ie=0; ie<c2nv[e]; ie++) {
-      int iep1 = (ie+1)%c2nv[e];
-      if (c2v[e][ie] < c2v[e][iep1]) {
-      edge[0] = c2v[e][ie];
-      edge[1] = c2v[e][iep1];
-      } else {
-        edge[0] = c2v[e][iep1];
-        edge[1] = c2v[e][ie];
+  // Hash each cell edge on its (sorted) vertex pair; edges are numbered in
+  // order of first appearance, looping over cells in order
+  unordered_map<uint64_t,int> edgeMap;
+  edgeMap.reserve(2*nEles+nEles/2);
+
+  int nEdgesCell = getMax(c2ne);
+  c2e.setup(nEles,nEdgesCell);
+  c2b.setup(nEles,nEdgesCell);
+  c2b.initializeToZero();
+
+  // e2c & e2v are built up as edges are found, then copied into matrix form
+  vector<array<int,2>> e2v1, e2c1, e2lf1;
+  e2v1.reserve(2*nEles+nEles/2);
+  e2c1.reserve(2*nEles+nEles/2);
+  e2lf1.reserve(2*nEles+nEles/2);
+
+  for (int ic=0; ic<nEles; ic++) {
+    for (int j=0; j<c2ne[ic]; j++) {
+      int jp1 = (j+1)%(c2ne[ic]);
+
+      // Store edges consistently to allow matching of duplicates
+      int iv1 = min(c2v[ic][j],c2v[ic][jp1]);
+      int iv2 = max(c2v[ic][j],c2v[ic][jp1]);
+      uint64_t key = edgeKey(iv1,iv2);
+
+      auto it = edgeMap.find(key);
+      if (it == edgeMap.end()) {
+        // New edge; put cell on left
+        int ie0 = e2v1.size();
+        edgeMap[key] = ie0;
+        e2v1.push_back({{iv1,iv2}});
+        e2c1.push_back({{ic,-1}});
+        e2lf1.push_back({{j,-1}});
+        c2e[ic][j] = ie0;
+      }
+      else {
+        // Existing edge; put cell on right
+        int ie0 = it->second;
+        if (e2c1[ie0][1] != -1) {
+          stringstream ss; ss << ie0;
+          string errMsg = "More than 2 cells for edge " + ss.str();
+          FatalError(errMsg.c_str());
+        }
+        e2c1[ie0][1] = ic;
+        e2lf1[ie0][1] = j;
+        c2e[ic][j] = ie0;
       }
-      e2v1.insertRow(edge);
     }
   }
 
-  /* --- Just for nDims==2: Get just the unique edges --- */
-  // iE is of length [original e2v1] with range [final e2v]
-  // The number of times an edge appears in iE is equal to
-  // the number of cells that edge touches
-  vector<int> iE;
-  e2v1.unique(e2v,iE);
-  nEdges = e2v.getDim0();
+  nEdges = e2v1.size();
+  e2v.setup(nEdges,2);
+  e2c.setup(nEdges,2);
+  e2lf.setup(nEdges,2);
+#pragma omp parallel for
+  for (int ie=0; ie<nEdges; ie++) {
+    e2v[ie][0] = e2v1[ie][0];  e2v[ie][1] = e2v1[ie][1];
+    e2c[ie][0] = e2c1[ie][0];  e2c[ie][1] = e2c1[ie][1];
+    e2lf[ie][0] = e2lf1[ie][0];  e2lf[ie][1] = e2lf1[ie][1];
+  }
 
   /* --- Determine interior vs. boundary edges/faces --- */
 
@@ -84,28 +164,26 @@ void geo::processConnectivity()
   nFaces = 0;
   nBndEdges = 0;
 
-  for (uint i=0; i<iE.size(); i++) {
-    if (iE[i]!=-1) {
-      vector<int> ie = findEq(iE,iE[i]);
-      if (ie.size()>2) {
-        stringstream ss; ss << i;
-        string errMsg = "More than 2 cells for edge " + ss.str();
-        FatalError(errMsg.c_str());
-      }
-      else if (ie.size()==2) {
-        // Internal Edge which has not yet been added
-        intEdges.push_back(iE[i]);
-        nFaces++;
-      }
-      else if (ie.size()==1) {
-        // Boundary Edge
-        bndEdges.push_back(iE[i]);
-        isBnd[iE[i]] = true;
-        nBndEdges++;
-      }
+  for (int ie=0; ie<nEdges; ie++) {
+    if (e2c[ie][1] != -1) {
+      // Internal Edge
+      intEdges.push_back(ie);
+      nFaces++;
+    }
+    else {
+      // Boundary Edge
+      bndEdges.push_back(ie);
+      isBnd[ie] = true;
+      nBndEdges++;
+    }
+  }
+
+  /* --- Setup Cell-To-Boundary flags --- */
 
-      // Mark edges as completed
-      vecAssign(iE,ie,-1);
+#pragma omp parallel for
+  for (int ic=0; ic<nEles; ic++) {
+    for (int j=0; j<c2ne[ic]; j++) {
+      c2b[ic][j] = isBnd[c2e[ic][j]];
     }
   }
 
@@ -115,76 +193,58 @@ void geo::processConnectivity()
   bndFaces.clear();
   bndFaces.resize(nBounds);
   bcType.assign(nBndEdges,-1);
-  for (int i=0; i<nBndEdges; i++) {
-    int iv1 = e2v[bndEdges[i]][0];
-    int iv2 = e2v[bndEdges[i]][1];
-    for (int bnd=0; bnd<nBounds; bnd++) {
-      if (findFirst(bndPts[bnd],iv1,bndPts.dim1)!=-1 && findFirst(bndPts[bnd],iv2,bndPts.dim1)!=-1) {
-        // The edge lies on this boundary
-        bcType[i] = bcList[bnd];
-        bndFaces[bnd].insertRow(e2v[bndEdges[i]],-1,e2v.dim1);
-        break;
-      }
+
+  // Bitmask of which boundaries each vertex lies on
+  if (nBounds > 64) FatalError("Maximum of 64 mesh boundaries supported.");
+  vector<uint64_t> v2bnd(xv.size(),0);
+  for (int bnd=0; bnd<nBounds; bnd++) {
+    for (int j=0; j<nBndPts[bnd]; j++) {
+      v2bnd[bndPts(bnd,j)] |= (1ULL << bnd);
     }
   }
 
-  /* --- Setup Cell-To-Edge, Edge-To-Cell --- */
-
-  c2e.setup(nEles,getMax(c2ne));
-  c2b.setup(nEles,getMax(c2ne));
-  c2b.initializeToZero();
-  e2c.setup(nEdges,2);
-  e2c.initializeToValue(-1);
-
-  for (int ic=0; ic<nEles; ic++) {
-    for (int j=0; j<c2ne[ic]; j++) {
-      int jp1 = (j+1)%(c2ne[ic]);
+  vector<int> bndID(nBndEdges,-1);
+#pragma omp parallel for
+  for (int i=0; i<nBndEdges; i++) {
+    int iv1 = e2v[bndEdges[i]][0];
+    int iv2 = e2v[bndEdges[i]][1];
 
-      // Store edges consistently to allow matching of duplicates
-      if (c2v[ic][j] < c2v[ic][jp1]) {
-      edge[0] = c2v[ic][j];
-      edge[1] = c2v[ic][jp1];
-      } else {
-        edge[0] = c2v[ic][jp1];
-        edge[1] = c2v[ic][j];
+    // Boundary faces read from the mesh file carry their boundary directly
+    if (!bndEdgeTags.empty()) {
+      auto it = bndEdgeTags.find(edgeKey(iv1,iv2));
+      if (it != bndEdgeTags.end()) {
+        bndID[i] = it->second;
+        continue;
       }
+    }
 
-      vector<int> ie1 = findEq(e2v.getCol(0),edge[0]);
-      vector<int> col2 = (e2v.getRows(ie1)).getCol(1);
-      int ie2 = findFirst(col2,edge[1]);
-      int ie0 = ie1[ie2];
-
-      // Find ID of face within type-specific array
-      if (isBnd[ie0]) {
-        c2e[ic][j] = ie0; //findFirst(bndEdges,ie0);
-        c2b[ic][j] = 1;
-      }else{
-        c2e[ic][j] = ie0; //findFirst(intEdges,ie0);
-        c2b[ic][j] = 0;
-      }
+    // Otherwise, the edge lies on the first boundary containing both vertices
+    uint64_t mask = v2bnd[iv1] & v2bnd[iv2];
+    if (mask)
+      bndID[i] = __builtin_ctzll(mask);
+  }
 
-      if (e2c[ie0][0] == -1) {
-        // No cell yet assigned to edge; put on left
-        e2c[ie0][0] = ic;
-      }else{
-        // Put cell on right
-        e2c[ie0][1] = ic;
-      }
-    }
+  for (int i=0; i<nBndEdges; i++) {
+    int bnd = bndID[i];
+    if (bnd < 0) continue;
+    bcType[i] = bcList[bnd];
+    bndFaces[bnd].insertRow(e2v[bndEdges[i]],-1,e2v.dim1);
   }
 }
 
 void geo::setupElesFaces(vector<ele> &eles, vector<face> &faces, vector<bound> &bounds)
 {
   if (nEles<=0) FatalError("Cannot setup elements array - nEles = 0");
+  if (c2v.getDim0()==0) FatalError("Cannot setup elements array - mesh connectivity has been released.");
 
   eles.resize(nEles);
   faces.resize(nFaces);
   bounds.resize(nBndEdges);
 
   // Setup the elements
-  int ic = 0;
-  for (auto& e:eles) {
+#pragma omp parallel for
+  for (int ic=0; ic<nEles; ic++) {
+    ele& e = eles[ic];
     e.ID = ic;
     e.eType = ctype[ic];
     e.nNodes = c2nv[ic];
@@ -206,89 +266,198 @@ void geo::setupElesFaces(vector<ele> &eles, vector<face> &faces, vector<bound> &
     }
 
     e.setup(params,this);
-
-    ic++;
   }
 
   /* --- Setup the faces --- */
 
-  vector<int> tmpEdges;
-  int i = 0;
-
   // Internal Faces
-  for (auto& F:faces) {
-    // Find global face ID of current interior face
+#pragma omp parallel for
+  for (int i=0; i<nFaces; i++) {
+    // Global face ID of current interior face & its local face ID within each element
     int ie = intEdges[i];
-    ic = e2c[ie][0];
-    // Find local face ID of global face within first element [on left]
-    tmpEdges.assign(c2e[ic],c2e[ic]+c2ne[ic]);
-    int fid1 = findFirst(tmpEdges,ie);
-    F.params = params;
+    faces[i].params = params;
     if (e2c[ie][1] == -1) {
       FatalError("Interior edge does not have a right element assigned.");
     }else{
-      ic = e2c[ie][1];
-      tmpEdges.assign(c2e[ic], c2e[ic]+c2ne[ic]);
-      //tmpEdges = c2e[e2c[ie][1]]; // previous row-as-vector form
-      int fid2 = findFirst(tmpEdges,ie);
-      F.setupFace(&eles[e2c[ie][0]],&eles[e2c[ie][1]],fid1,fid2,ie);
+      faces[i].setupFace(&eles[e2c[ie][0]],&eles[e2c[ie][1]],e2lf[ie][0],e2lf[ie][1],ie);
     }
-
-    i++;
   }
 
   // Boundary Faces
-  i = 0;
-  for (auto& B:bounds) {
-    // Find global face ID of current boundary face
+#pragma omp parallel for
+  for (int i=0; i<nBndEdges; i++) {
+    // Global face ID of current boundary face & its local face ID within the element
     int ie = bndEdges[i];
-    ic = e2c[ie][0];
-    // Find local face ID of global face within element
-    tmpEdges.assign(c2e[ic],c2e[ic]+c2ne[ic]);
-    int fid1 = findFirst(tmpEdges,ie);
-    B.params = params;
+    bounds[i].params = params;
     if (e2c[ie][1] != -1) {
       FatalError("Boundary edge has a right element assigned.");
     }else{
-      B.setupBound(&eles[e2c[ie][0]],fid1,bcType[i],ie);
+      bounds[i].setupBound(&eles[e2c[ie][0]],e2lf[ie][0],bcType[i],ie);
     }
+  }
+}
+
+size_t geo::releaseConnectivity(void)
+{
+  size_t bytes = 0;
+
+  for (auto* mat:{&c2v, &c2e, &c2b, &e2c, &e2v, &v2e, &v2v, &v2c, &e2lf, &bndPts}) {
+    bytes += mat->getMemSize();
+    mat->clear();
+  }
+
+  for (auto& mat:bndFaces) bytes += mat.getMemSize();
+  bytes += freeVector(bndFaces);
+
+  bytes += freeVector(xv);
+  bytes += freeVector(v2nv) + freeVector(v2nc) + freeVector(c2nv) + freeVector(c2ne) + freeVector(ctype);
+  bytes += freeVector(intEdges) + freeVector(bndEdges) + freeVector(bcType);
+  bytes += freeVector(nBndPts) + freeVector(nBndFaces);
+  bytes += freeVector(isBnd);
+
+  bytes += bndEdgeTags.size()*(sizeof(uint64_t)+sizeof(int)) + bndEdgeTags.bucket_count()*sizeof(void*);
+  unordered_map<uint64_t,int>().swap(bndEdgeTags);
 
-    i++;
+  return bytes;
+}
+
+/* ---- Helper routines for parsing memory-mapped Gmsh files ---- */
+
+//! Find the start of the line following the given Gmsh section tag (e.g. "$Nodes")
+static const char* findSection(const char* begin, const char* end, const string &tag)
+{
+  string key = tag + "\n";
+  const char* p = std::search(begin, end, key.begin(), key.end());
+  if (p == end) {
+    // Allow for Windows line endings
+    key = tag + "\r\n";
+    p = std::search(begin, end, key.begin(), key.end());
+  }
+  if (p == end) return NULL;
+  return p + key.size();
+}
+
+//! Pointer to the start of the next line
+static inline const char* nextLine(const char* p, const char* end)
+{
+  const void* eol = memchr(p, '\n', end-p);
+  return (eol == NULL) ? end : (const char*)eol + 1;
+}
+
+//! Get the start of each of the next nLines lines
+static void splitLines(const char* &p, const char* end, size_t nLines, vector<const char*> &lines)
+{
+  lines.resize(nLines);
+  for (size_t i=0; i<nLines; i++) {
+    lines[i] = p;
+    p = nextLine(p,end);
+  }
+}
+
+static inline long readInt(const char* &p)
+{
+  return strtol(p, (char**)&p, 10);
+}
+
+static inline double readDouble(const char* &p)
+{
+  return strtod(p, (char**)&p);
+}
+
+template<typename T>
+static inline T readBinary(const char* &p)
+{
+  T val;
+  memcpy(&val, p, sizeof(T));
+  p += sizeof(T);
+  return val;
+}
+
+//! Number of nodes for the supported Gmsh element types [0 if unsupported]
+static int gmshNodesPerEle(int eType)
+{
+  switch (eType) {
+    case 15: return 1;  // point
+    case 1:  return 2;  // linear edge
+    case 8:  return 3;  // quadratic edge
+    case 26: return 4;  // cubic edge
+    case 27: return 5;  // quartic edge
+    case 28: return 6;  // quintic edge
+    case 3:  return 4;  // linear quadrangle
+    case 16: return 8;  // quadratic 8-node (serendipity) quadrangle
+    case 10: return 9;  // quadratic 9-node (Lagrange) quadrangle
+    default: return 0;
   }
 }
 
 void geo::readGmsh(string fileName)
 {
-  ifstream meshFile;
-  string str;
+  /* --- Memory-map the mesh file --- */
 
-  meshFile.open(fileName.c_str());
-  if (!meshFile.is_open())
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
     FatalError("Unable to open mesh file.");
 
-  /* --- Read Boundary Conditions & Fluid Field(s) --- */
+  struct stat st;
+  fstat(fd, &st);
+  size_t fileSize = st.st_size;
+
+  void* fileMap = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (fileMap == MAP_FAILED)
+    FatalError("Unable to memory-map mesh file.");
+  madvise(fileMap, fileSize, MADV_SEQUENTIAL);
 
-  // Move cursor to $PhysicalNames
-  while(1) {
-    getline(meshFile,str);
-    if (str.find("$PhysicalNames")!=string::npos) break;
-    if(meshFile.eof()) FatalError("$PhysicalNames tag not found in Gmsh file!");
+  const char* begin = (const char*)fileMap;
+  const char* end = begin + fileSize;
+  const char* p;
+
+  /* --- Read the Mesh Format --- */
+
+  p = findSection(begin,end,"$MeshFormat");
+  if (p == NULL) FatalError("$MeshFormat tag not found in Gmsh file!");
+
+  double version = readDouble(p);
+  int fileType = readInt(p);
+  int dataSize = readInt(p);
+  p = nextLine(p,end);
+
+  bool binary = (fileType == 1);
+  int vMajor = (int)version;
+
+  if (vMajor == 2 && binary)
+    FatalError("Binary Gmsh 2.x files not supported - use ASCII 2.2 or 4.1 format.");
+  if (vMajor == 4 && std::abs(version-4.1) > 1e-6)
+    FatalError("Gmsh 4.x files must be version 4.1.");
+  if (vMajor != 2 && vMajor != 4)
+    FatalError("Unsupported Gmsh file version - use 2.2 or 4.1.");
+
+  if (binary) {
+    if (dataSize != sizeof(size_t))
+      FatalError("Gmsh binary file data-size does not match size_t.");
+    if (readBinary<int>(p) != 1)
+      FatalError("Gmsh binary file has a different endianness.");
   }
 
+  /* --- Read Boundary Conditions & Fluid Field(s) --- */
+
+  p = findSection(begin,end,"$PhysicalNames");
+  if (p == NULL) FatalError("$PhysicalNames tag not found in Gmsh file!");
+
   // Read number of boundaries and fields defined
-  int nBnds;              // Temp. variable for # of Gmsh regions ("PhysicalNames")
-  meshFile >> nBnds;
-  getline(meshFile,str);  // clear rest of line
+  int nBnds = readInt(p);  // Temp. variable for # of Gmsh regions ("PhysicalNames")
+  p = nextLine(p,end);
 
+  map<int,int> phys2bnd;   // Maps Gmsh physical tag to index in bcList
   nBounds = 0;
   for (int i=0; i<nBnds; i++) {
     string bcStr;
     stringstream ss;
     int bcdim, bcid;
 
-    getline(meshFile,str);
-    ss << str;
+    const char* pNext = nextLine(p,end);
+    ss << string(p,pNext);
     ss >> bcdim >> bcid >> bcStr;
+    p = pNext;
 
     // Remove quotation marks from around boundary condition
     size_t ind = bcStr.find("\"");
@@ -315,6 +484,7 @@ void geo::readGmsh(string fileName)
       FatalError(errS.c_str());
     }
 
+    phys2bnd[bcid] = bcList.size();
     bcList.push_back(bcNum[bcStr]);
 
     if (bcStr.compare("fluid")==0) {
@@ -330,151 +500,313 @@ void geo::readGmsh(string fileName)
     FatalError("Only 2D meshes are currently supported - check that your mesh is setup properly.");
   }
 
+  /* --- Gmsh 4: Read physical tags of each geometric entity --- */
+
+  // For each entity dimension: entity tag -> (first) physical tag
+  vector<map<int,int>> ent2phys(4);
+
+  if (vMajor == 4) {
+    p = findSection(begin,end,"$Entities");
+    if (p == NULL) FatalError("$Entities tag not found in Gmsh file!");
+
+    size_t nEnts[4];
+    for (int dim=0; dim<4; dim++)
+      nEnts[dim] = (binary) ? readBinary<size_t>(p) : readInt(p);
+
+    for (int dim=0; dim<4; dim++) {
+      for (size_t i=0; i<nEnts[dim]; i++) {
+        int tag;
+        size_t nPhys;
+        if (binary) {
+          tag = readBinary<int>(p);
+          p += (dim==0) ? 3*sizeof(double) : 6*sizeof(double);  // Bounding box
+          nPhys = readBinary<size_t>(p);
+          for (size_t j=0; j<nPhys; j++) {
+            int phys = readBinary<int>(p);
+            if (j==0) ent2phys[dim][tag] = std::abs(phys);
+          }
+          if (dim > 0) {
+            size_t nBndEnts = readBinary<size_t>(p);
+            p += nBndEnts*sizeof(int);
+          }
+        }
+        else {
+          tag = readInt(p);
+          for (int j=0; j<((dim==0) ? 3 : 6); j++)  // Bounding box
+            readDouble(p);
+          nPhys = readInt(p);
+          for (size_t j=0; j<nPhys; j++) {
+            int phys = readInt(p);
+            if (j==0) ent2phys[dim][tag] = std::abs(phys);
+          }
+          if (dim > 0) {
+            size_t nBndEnts = readInt(p);
+            for (size_t j=0; j<nBndEnts; j++)
+              readInt(p);
+          }
+        }
+      }
+    }
+  }
+
   /* --- Read Mesh Vertex Locations --- */
 
-  // Move cursor to $Nodes
-  meshFile.clear();
-  meshFile.seekg(0, ios::beg);
-  while(1) {
-    getline(meshFile,str);
-    if (str.find("$Nodes")!=string::npos) break;
-    if(meshFile.eof()) FatalError("$Nodes tag not found in Gmsh file!");
+  p = findSection(begin,end,"$Nodes");
+  if (p == NULL) FatalError("$Nodes tag not found in Gmsh file!");
+
+  vector<size_t> nodeTags;  // Gmsh tag of each node, in file order
+  vector<const char*> lines;
+
+  if (vMajor == 2) {
+    uint nNodes = readInt(p);
+    p = nextLine(p,end);
+    xv.resize(nNodes);
+    nodeTags.resize(nNodes);
+
+    splitLines(p,end,nNodes,lines);
+#pragma omp parallel for
+    for (uint i=0; i<nNodes; i++) {
+      const char* q = lines[i];
+      nodeTags[i] = readInt(q);
+      xv[i].x = readDouble(q);
+      xv[i].y = readDouble(q);
+      xv[i].z = readDouble(q);
+    }
+  }
+  else {
+    size_t nBlocks, nNodes;
+    if (binary) {
+      nBlocks = readBinary<size_t>(p);
+      nNodes = readBinary<size_t>(p);
+      p += 2*sizeof(size_t);  // min, max node tag
+    } else {
+      nBlocks = readInt(p);
+      nNodes = readInt(p);
+      p = nextLine(p,end);
+    }
+    xv.resize(nNodes);
+    nodeTags.resize(nNodes);
+
+    size_t n0 = 0;
+    for (size_t b=0; b<nBlocks; b++) {
+      int entDim, parametric;
+      size_t nInBlock;
+      if (binary) {
+        entDim = readBinary<int>(p);
+        readBinary<int>(p);  // entity tag
+        parametric = readBinary<int>(p);
+        nInBlock = readBinary<size_t>(p);
+
+        memcpy(&nodeTags[n0], p, nInBlock*sizeof(size_t));
+        p += nInBlock*sizeof(size_t);
+
+        int nVals = 3 + ((parametric) ? entDim : 0);
+        for (size_t i=0; i<nInBlock; i++) {
+          xv[n0+i].x = readBinary<double>(p);
+          xv[n0+i].y = readBinary<double>(p);
+          xv[n0+i].z = readBinary<double>(p);
+          p += (nVals-3)*sizeof(double);
+        }
+      }
+      else {
+        entDim = readInt(p);
+        readInt(p);  // entity tag
+        parametric = readInt(p);
+        nInBlock = readInt(p);
+        p = nextLine(p,end);
+        (void)entDim; (void)parametric;
+
+        // Node tags (one per line), followed by coordinates (one node per line)
+        splitLines(p,end,2*nInBlock,lines);
+#pragma omp parallel for
+        for (size_t i=0; i<nInBlock; i++) {
+          const char* q = lines[i];
+          nodeTags[n0+i] = readInt(q);
+          q = lines[nInBlock+i];
+          xv[n0+i].x = readDouble(q);
+          xv[n0+i].y = readDouble(q);
+          xv[n0+i].z = readDouble(q);
+        }
+      }
+      n0 += nInBlock;
+    }
   }
 
-  uint nNodes, iv;
-  meshFile >> nNodes;
-  xv.resize(nNodes);
-  getline(meshFile,str); // Clear end of line, just in case
+  // Map from Gmsh node tag to node index
+  size_t maxTag = 0;
+  for (auto& tag:nodeTags) maxTag = max(maxTag,tag);
+  vector<int> tag2node(maxTag+1,-1);
+  for (size_t i=0; i<nodeTags.size(); i++)
+    tag2node[nodeTags[i]] = i;
+
+  /* --- Read Element Connectivity --- */
 
-  for (uint i=0; i<nNodes; i++) {
-    meshFile >> iv >> xv[i].x >> xv[i].y >> xv[i].z;
+  p = findSection(begin,end,"$Elements");
+  if (p == NULL) FatalError("$Elements tag not found in Gmsh file!");
+
+  // Gmsh element type, physical tag, and node tags of every element, in file order
+  const int maxNodes = 9;  // Maximum number of nodes/element possible
+  vector<int> eleType, elePhys;
+  vector<size_t> eleNodes;
+
+  if (vMajor == 2) {
+    size_t nElesGmsh = readInt(p);
+    p = nextLine(p,end);
+    eleType.resize(nElesGmsh);
+    elePhys.resize(nElesGmsh);
+    eleNodes.resize(nElesGmsh*maxNodes);
+
+    splitLines(p,end,nElesGmsh,lines);
+#pragma omp parallel for
+    for (size_t k=0; k<nElesGmsh; k++) {
+      const char* q = lines[k];
+      readInt(q);  // id
+      eleType[k] = readInt(q);
+      int nTags = readInt(q);
+      elePhys[k] = (nTags > 0) ? readInt(q) : 0;
+      for (int tag=0; tag<nTags-1; tag++)
+        readInt(q);
+      int nv = gmshNodesPerEle(eleType[k]);
+      for (int i=0; i<nv; i++)
+        eleNodes[k*maxNodes+i] = readInt(q);
+    }
   }
+  else {
+    size_t nBlocks, nElesGmsh;
+    if (binary) {
+      nBlocks = readBinary<size_t>(p);
+      nElesGmsh = readBinary<size_t>(p);
+      p += 2*sizeof(size_t);  // min, max element tag
+    } else {
+      nBlocks = readInt(p);
+      nElesGmsh = readInt(p);
+      p = nextLine(p,end);
+    }
+    eleType.resize(nElesGmsh);
+    elePhys.resize(nElesGmsh);
+    eleNodes.resize(nElesGmsh*maxNodes);
+
+    size_t k0 = 0;
+    for (size_t b=0; b<nBlocks; b++) {
+      int entDim, entTag, eType;
+      size_t nInBlock;
+      if (binary) {
+        entDim = readBinary<int>(p);
+        entTag = readBinary<int>(p);
+        eType = readBinary<int>(p);
+        nInBlock = readBinary<size_t>(p);
+      } else {
+        entDim = readInt(p);
+        entTag = readInt(p);
+        eType = readInt(p);
+        nInBlock = readInt(p);
+        p = nextLine(p,end);
+      }
 
-  /* --- Read Element Connectivity --- */
+      int phys = (ent2phys[entDim].count(entTag)) ? ent2phys[entDim][entTag] : 0;
+      int nv = gmshNodesPerEle(eType);
+      if (nv == 0) {
+        cout << "Gmsh Element Type = " << eType << endl;
+        FatalError("element type not recognized");
+      }
 
-  // Move cursor to $Elements
-  meshFile.clear();
-  meshFile.seekg(0, ios::beg);
-  while(1) {
-    getline(meshFile,str);
-    if (str.find("$Elements")!=string::npos) break;
-    if(meshFile.eof()) FatalError("$Elements tag not found in Gmsh file!");
-  }
-
-  int nElesGmsh;
-  vector<int> c2v_tmp(9,0);  // Maximum number of nodes/element possible
-  vector<set<int>> boundPoints(nBounds);
-  map<int,int> eType2nv;
-  eType2nv[3] = 4;
-  eType2nv[16] = 4;
-  eType2nv[10] = 4;
-
-  // Setup bndPts matrix - Just an initial estimate; will be adjusted on the fly
-  //bndPts.setup(nBounds,std::round(nNodes/nBounds));
-  nBndPts.resize(nBounds);
+      if (binary) {
+        for (size_t k=0; k<nInBlock; k++) {
+          p += sizeof(size_t);  // element tag
+          memcpy(&eleNodes[(k0+k)*maxNodes], p, nv*sizeof(size_t));
+          p += nv*sizeof(size_t);
+        }
+      }
+      else {
+        splitLines(p,end,nInBlock,lines);
+#pragma omp parallel for
+        for (size_t k=0; k<nInBlock; k++) {
+          const char* q = lines[k];
+          readInt(q);  // element tag
+          for (int i=0; i<nv; i++)
+            eleNodes[(k0+k)*maxNodes+i] = readInt(q);
+        }
+      }
+
+      for (size_t k=0; k<nInBlock; k++) {
+        eleType[k0+k] = eType;
+        elePhys[k0+k] = phys;
+      }
+      k0 += nInBlock;
+    }
+  }
+
+  munmap(fileMap, fileSize);
+  close(fd);
 
-  // Read total number of interior + boundary elements
-  meshFile >> nElesGmsh;
-  getline(meshFile,str);    // Clear end of line, just in case
+  /* --- Sort elements into interior cells & boundary faces --- */
+
+  vector<set<int>> boundPoints(bcList.size());
+  nBndPts.resize(nBounds);
 
   // For Gmsh node ordering, see: http://geuz.org/gmsh/doc/texinfo/gmsh.html#Node-ordering
-  int ic = 0;
-  for (int k=0; k<nElesGmsh; k++) {
-    int id, eType, nTags, bcid, tmp;
-    meshFile >> id >> eType >> nTags;
-    meshFile >> bcid; bcid--; // NOTE: Gmsh is 1-indexed
-    for (int tag=0; tag<nTags-1; tag++)
-      meshFile >> tmp;
+  int maxNv = 0;
+  vector<int> cells;
+  for (size_t k=0; k<eleType.size(); k++) {
+    if (!phys2bnd.count(elePhys[k])) continue;  // Entity not part of any physical group
+    int bcid = phys2bnd[elePhys[k]];
 
     if (bcList[bcid] == NONE) {
       // NOTE: Currently, only quads are supported
-      switch(eType) {
+      switch(eleType[k]) {
       case 3:
         // linear quadrangle
-        //ctype(i) = 1;
         c2nv.push_back(4);
-        c2ne.push_back(4);
-        ctype.push_back(QUAD);
-        meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3];
         break;
 
       case 16:
         // quadratic 8-node (serendipity) quadrangle
-        c2nv.push_back(8); //c2nv[i] = 8;
-        c2ne.push_back(4);
-        ctype.push_back(QUAD);
-        meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6] >> c2v_tmp[7];
+        c2nv.push_back(8);
         break;
 
       case 10:
         // quadratic (9-node Lagrange) quadrangle
-        c2nv.push_back(9); //c2nv[i] = 9;
-        c2ne.push_back(4);
-        ctype.push_back(QUAD);
-        meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6] >> c2v_tmp[7] >> c2v_tmp[8];
+        c2nv.push_back(9);
         break;
 
       default:
-        cout << "Gmsh Element Type = " << eType << endl;
+        cout << "Gmsh Element Type = " << eleType[k] << endl;
         FatalError("element type not recognized");
         break;
       }
-
-      // Increase the size of c2v (max # of vertices per cell) if needed
-      if (c2v.getDim1()<(uint)c2nv[ic]) {
-        for (int dim=c2v.getDim1(); dim<c2nv[ic]; dim++) {
-          c2v.addCol();
-        }
-      }
-
-      // Number of nodes in c2v_tmp may vary, so use pointer rather than vector
-      c2v.insertRow(c2v_tmp.data(),-1,c2nv[ic]);
-
-      // Shift every value of c2v by -1 (Gmsh is 1-indexed; we need 0-indexed)
-      for(int k=0; k<c2nv[ic]; k++) {
-        if(c2v(ic,k)!=0) {
-          c2v(ic,k)--;
-        }
-      }
-
-      ic++;
-      getline(meshFile,str); // skip end of line
+      c2ne.push_back(4);
+      ctype.push_back(QUAD);
+      maxNv = max(maxNv,c2nv.back());
+      cells.push_back(k);
     }
     else {
-      // Boundary cell; put vertices into bndPts
+      // Boundary face; put vertices into bndPts
       int nPtsEdge = 0;
-      switch(eType) {
-      case 1: // Linear edge
-        nPtsEdge = 2;
-        break;
-
-      case 8: // Quadratic edge
-        nPtsEdge = 3;
-        break;
-
-      case 26: // Cubic Edge
-        nPtsEdge = 4;
-        break;
-
-      case 27: // Quartic Edge
-        nPtsEdge = 5;
-        break;
-
-      case 28: // Quintic Edge
-        nPtsEdge = 6;
+      switch(eleType[k]) {
+      case 1: case 8: case 26: case 27: case 28:
+        nPtsEdge = gmshNodesPerEle(eleType[k]);
         break;
 
       default:
           FatalError("Boundary Element (Face) Type Not Recognized!");
       }
 
-      for (int i=0; i<nPtsEdge; i++) {
-        meshFile >> iv;  iv--;
-        boundPoints[bcid].insert(iv);
-      }
-      getline(meshFile,str);
+      for (int i=0; i<nPtsEdge; i++)
+        boundPoints[bcid].insert(tag2node[eleNodes[k*maxNodes+i]]);
+
+      // Carry the physical tag directly to the face [first two nodes are the corners]
+      bndEdgeTags[edgeKey(tag2node[eleNodes[k*maxNodes]],tag2node[eleNodes[k*maxNodes+1]])] = bcid;
     }
-  } // End of loop over entities
+  }
+
+  nEles = cells.size();
+  c2v.setup(nEles,maxNv);
+  c2v.initializeToZero();
+#pragma omp parallel for
+  for (int ic=0; ic<nEles; ic++) {
+    for (int i=0; i<c2nv[ic]; i++)
+      c2v(ic,i) = tag2node[eleNodes[cells[ic]*maxNodes+i]];
+  }
 
   int maxNBndPts = 0;
   for (int i=0; i<nBounds; i++) {
@@ -492,10 +824,6 @@ void geo::readGmsh(string fileName)
       j++;
     }
   }
-
-  nEles = c2v.getDim0();
-
-  meshFile.close();
 }
 
 void geo::createMesh()
@@ -645,51 +973,432 @@ void geo::processPeriodicBoundaries(void)
   if (nPeriodic == 0) return;
   if (nPeriodic%2 != 0) FatalError("Expecting even number of periodic faces; have odd number.");
 
-  for (auto& i:iPeriodic) {
+  /* --- Hash the midpoint of each periodic face into a tolerance-sized grid --- */
+  double tol = params->periodicTol;
+  auto binKey = [tol](double x, double y) {
+    int64_t ix = (int64_t)floor(x/tol);
+    int64_t iy = (int64_t)floor(y/tol);
+    return (uint64_t)ix*73856093ULL ^ (uint64_t)iy*19349663ULL;
+  };
+
+  vector<point> midPts(nPeriodic);
+  unordered_map<uint64_t,vector<int>> bins;
+  bins.reserve(nPeriodic);
+  for (uint k=0; k<nPeriodic; k++) {
+    int* edge = e2v[bndEdges[iPeriodic[k]]];
+    midPts[k].x = 0.5*(xv[edge[0]][0]+xv[edge[1]][0]);
+    midPts[k].y = 0.5*(xv[edge[0]][1]+xv[edge[1]][1]);
+    bins[binKey(midPts[k].x,midPts[k].y)].push_back(iPeriodic[k]);
+  }
+
+  // Possible translations between matching faces
+  double dx = params->periodicDX;
+  double dy = params->periodicDY;
+  array<array<double,2>,4> shifts = {{ {{dx,0}}, {{-dx,0}}, {{0,dy}}, {{0,-dy}} }};
+
+  for (uint k=0; k<nPeriodic; k++) {
+    int i = iPeriodic[k];
     if (bndEdges[i]==-1) continue;
-    for (auto& j:iPeriodic) {
-      if (i==j || bndEdges[i]==-1 || bndEdges[j]==-1) continue;
-      if (checkPeriodicFaces(e2v[bndEdges[i]],e2v[bndEdges[j]])) {
 
-        /* --- Match found - now take care of transfer from boundary -> internal --- */
+    // Find the lowest-numbered unmatched face which matches up with face i, checking
+    // only faces whose midpoint lies in (or next to) the bin of a translated midpoint
+    int j = -1;
+    for (auto& shift:shifts) {
+      double xs = midPts[k].x + shift[0];
+      double ys = midPts[k].y + shift[1];
+      for (int di=-1; di<=1; di++) {
+        for (int dj=-1; dj<=1; dj++) {
+          auto it = bins.find(binKey(xs+di*tol,ys+dj*tol));
+          if (it == bins.end()) continue;
+          for (auto& jj:it->second) {
+            if (jj==i || bndEdges[jj]==-1 || (j!=-1 && jj>=j)) continue;
+            if (checkPeriodicFaces(e2v[bndEdges[i]],e2v[bndEdges[jj]]))
+              j = jj;
+          }
+        }
+      }
+    }
 
-        if (i>j) FatalError("How did this happen?!");
+    if (j != -1) {
+      /* --- Match found - now take care of transfer from boundary -> internal --- */
 
-        bi = bndEdges[i];
-        bj = bndEdges[j];
+      if (i>j) FatalError("How did this happen?!");
 
-        // Transfer combined edge from boundary to internal list
-        intEdges.push_back(bi);
+      bi = bndEdges[i];
+      bj = bndEdges[j];
 
-        // Flag global edge IDs as internal edges
-        isBnd[bi] = false;
-        isBnd[bj] = false;
+      // Transfer combined edge from boundary to internal list
+      intEdges.push_back(bi);
 
-        // Fix e2c - add right cell to combined edge, make left cell = -1 in 'deleted' edge
-        e2c[bi][1] = e2c[bj][0];
-        e2c[bj][0] = -1;
+      // Flag global edge IDs as internal edges
+      isBnd[bi] = false;
+      isBnd[bj] = false;
 
-        // Fix c2e - replace 'deleted' edge from right cell with combined edge
-        ic = e2c[bi][1];
-        int fID = findFirst(c2e[ic],(int)bj,c2ne[ic]);
-        c2e[e2c[bi][1]][fID] = bi;
+      // Fix e2c - add right cell to combined edge, make left cell = -1 in 'deleted' edge
+      e2c[bi][1] = e2c[bj][0];
+      e2c[bj][0] = -1;
 
-        // Fix c2b - set element-local face to be internal face
-        c2b[e2c[bi][1]][fID] = false;
+      // Fix e2lf - local face ID within the new right cell
+      e2lf[bi][1] = e2lf[bj][0];
+      e2lf[bj][0] = -1;
 
-        // Flag edges as gone in boundary edges list
-        bndEdges[i] = -1;
-        bndEdges[j] = -1;
-      }
+      // Fix c2e - replace 'deleted' edge from right cell with combined edge
+      ic = e2c[bi][1];
+      int fID = e2lf[bi][1];
+      c2e[ic][fID] = bi;
+
+      // Fix c2b - set element-local face to be internal face (in both cells)
+      c2b[ic][fID] = false;
+      c2b[e2c[bi][0]][e2lf[bi][0]] = false;
+
+      // Flag edges as gone in boundary edges list
+      bndEdges[i] = -1;
+      bndEdges[j] = -1;
     }
   }
 
-  // Remove no-longer-existing periodic boundary edges and update nBndEdges
-  bndEdges.erase(std::remove(bndEdges.begin(), bndEdges.end(), -1), bndEdges.end());
-  nBndEdges = bndEdges.size();
+  // Remove no-longer-existing periodic boundary edges (and their BC's) and update nBndEdges
+  int nb = 0;
+  for (int i=0; i<nBndEdges; i++) {
+    if (bndEdges[i] == -1) continue;
+    bndEdges[nb] = bndEdges[i];
+    bcType[nb] = bcType[i];
+    nb++;
+  }
+  bndEdges.resize(nb);
+  bcType.resize(nb);
+  nBndEdges = nb;
   nFaces = intEdges.size();
 }
 
+void geo::setupNeighbors(void)
+{
+  c2c.setup(nEles,getMax(c2ne));
+  c2c.initializeToValue(-1);
+
+  for (int ic=0; ic<nEles; ic++) {
+    for (int j=0; j<c2ne[ic]; j++) {
+      if (c2b[ic][j]) continue;
+      int ie = c2e[ic][j];
+      c2c[ic][j] = (e2c[ie][0] == ic) ? e2c[ie][1] : e2c[ie][0];
+    }
+  }
+}
+
+int geo::getNbLocalFace(int ic, int locF)
+{
+  int nb = c2c[ic][locF];
+  if (nb < 0) return -1;
+
+  for (int k=0; k<c2ne[nb]; k++)
+    if (c2c[nb][k] == ic && c2e[nb][k] == c2e[ic][locF]) return k;
+
+  return -1;
+}
+
+void geo::setupStructured(void)
+{
+  int nx = params->nx;
+  int ny = params->ny;
+
+  periodicX = (bcNum[params->create_bcLeft] == PERIODIC);
+  periodicY = (bcNum[params->create_bcBottom] == PERIODIC);
+  if (periodicX != (bcNum[params->create_bcRight] == PERIODIC))
+    FatalError("Left & right boundaries must both be periodic, or neither.");
+  if (periodicY != (bcNum[params->create_bcTop] == PERIODIC))
+    FatalError("Bottom & top boundaries must both be periodic, or neither.");
+
+  // # of interior faces in each direction (i-faces: right face of cell (i,j); j-faces: top face)
+  int nxFaces = (periodicX) ? nx : nx-1;
+  int nyFaces = (periodicY) ? ny : ny-1;
+
+  /* --- Boundary Faces: [cell, local face, BC] in order bottom, right, top, left --- */
+  e2c.setup(2*(nx+ny),2);
+  e2lf.setup(2*(nx+ny),2);
+  bndEdges.resize(0);
+  bcType.resize(0);
+  nBndEdges = 0;
+  auto addBound = [&](int ic, int locF, int bc) {
+    e2c[nBndEdges][0] = ic;  e2c[nBndEdges][1] = -1;
+    e2lf[nBndEdges][0] = locF;  e2lf[nBndEdges][1] = -1;
+    bndEdges.push_back(nBndEdges);
+    bcType.push_back(bc);
+    nBndEdges++;
+  };
+
+  if (!periodicY)
+    for (int i=0; i<nx; i++) addBound(i*ny, 0, bcNum[params->create_bcBottom]);
+  if (!periodicX)
+    for (int j=0; j<ny; j++) addBound((nx-1)*ny+j, 1, bcNum[params->create_bcRight]);
+  if (!periodicY)
+    for (int i=0; i<nx; i++) addBound(i*ny+ny-1, 2, bcNum[params->create_bcTop]);
+  if (!periodicX)
+    for (int j=0; j<ny; j++) addBound(j, 3, bcNum[params->create_bcLeft]);
+
+  nFaces = 0;
+  intEdges.resize(0);
+  nEdges = nBndEdges + nxFaces*ny + nx*nyFaces;
+
+  /* --- Cell Connectivity --- */
+  // Edge IDs: boundary edges first, then i-faces, then j-faces
+  auto iFace = [&](int i, int j) { return nBndEdges + i*ny + j; };
+  auto jFace = [&](int i, int j) { return nBndEdges + nxFaces*ny + i*nyFaces + j; };
+
+  c2e.setup(nEles,4);
+  c2b.setup(nEles,4);
+  c2c.setup(nEles,4);
+  c2b.initializeToZero();
+  c2c.initializeToValue(-1);
+
+  int ib = 0;
+  if (!periodicY) {
+    for (int i=0; i<nx; i++) { c2e[i*ny][0] = ib++;  c2b[i*ny][0] = 1; }
+  }
+  if (!periodicX) {
+    for (int j=0; j<ny; j++) { c2e[(nx-1)*ny+j][1] = ib++;  c2b[(nx-1)*ny+j][1] = 1; }
+  }
+  if (!periodicY) {
+    for (int i=0; i<nx; i++) { c2e[i*ny+ny-1][2] = ib++;  c2b[i*ny+ny-1][2] = 1; }
+  }
+  if (!periodicX) {
+    for (int j=0; j<ny; j++) { c2e[j][3] = ib++;  c2b[j][3] = 1; }
+  }
+
+#pragma omp parallel for
+  for (int i=0; i<nx; i++) {
+    for (int j=0; j<ny; j++) {
+      int ic = i*ny + j;
+      if (j>0 || periodicY) {
+        int jm = (j+ny-1)%ny;
+        c2e[ic][0] = jFace(i,jm);
+        c2c[ic][0] = i*ny + jm;
+      }
+      if (i<nx-1 || periodicX) {
+        c2e[ic][1] = iFace(i,j);
+        c2c[ic][1] = ((i+1)%nx)*ny + j;
+      }
+      if (j<ny-1 || periodicY) {
+        c2e[ic][2] = jFace(i,j);
+        c2c[ic][2] = i*ny + (j+1)%ny;
+      }
+      if (i>0 || periodicX) {
+        int im = (i+nx-1)%nx;
+        c2e[ic][3] = iFace(im,j);
+        c2c[ic][3] = im*ny + j;
+      }
+    }
+  }
+}
+
+/* ---- Preprocessed-mesh cache ---- */
+
+//! Version of the mesh-cache file layout; increment whenever the layout changes
+static const uint32_t meshCacheVersion = 3;
+static const char meshCacheMagic[8] = {'F','L','R','Y','M','E','S','H'};
+
+//! 64-bit FNV-1a hash
+static uint64_t fnv1a(const void* data, size_t n, uint64_t hash = 14695981039346656037ULL)
+{
+  const unsigned char* p = (const unsigned char*)data;
+  for (size_t i=0; i<n; i++) {
+    hash ^= p[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+template<typename T>
+static void writeCacheData(ofstream &file, const T* data, uint64_t n)
+{
+  file.write((const char*)&n, sizeof(uint64_t));
+  if (n > 0) file.write((const char*)data, n*sizeof(T));
+}
+
+template<typename T>
+static void writeCacheData(ofstream &file, matrix<T> &mat)
+{
+  uint64_t dims[2] = {mat.getDim0(), mat.getDim1()};
+  file.write((const char*)dims, 2*sizeof(uint64_t));
+  if (dims[0]*dims[1] > 0) file.write((const char*)mat[0], dims[0]*dims[1]*sizeof(T));
+}
+
+//! Read a length-prefixed array; returns false if it would run past end
+template<typename T>
+static bool readCacheData(const char* &p, const char* end, vector<T> &vec)
+{
+  uint64_t n;
+  if ((size_t)(end-p) < sizeof(uint64_t)) return false;
+  memcpy(&n, p, sizeof(uint64_t));  p += sizeof(uint64_t);
+  if (n > (size_t)(end-p)/sizeof(T)) return false;
+  vec.resize(n);
+  if (n > 0) memcpy(vec.data(), p, n*sizeof(T));
+  p += n*sizeof(T);
+  return true;
+}
+
+//! Read a dimension-prefixed matrix; returns false if it would run past end
+template<typename T>
+static bool readCacheData(const char* &p, const char* end, matrix<T> &mat)
+{
+  uint64_t dims[2];
+  if ((size_t)(end-p) < 2*sizeof(uint64_t)) return false;
+  memcpy(dims, p, 2*sizeof(uint64_t));  p += 2*sizeof(uint64_t);
+  if (dims[1] > 0 && dims[0] > (size_t)(end-p)/sizeof(T)/dims[1]) return false;
+  mat.setup(dims[0],dims[1]);
+  if (dims[0]*dims[1] > 0) memcpy(mat[0], p, dims[0]*dims[1]*sizeof(T));
+  p += dims[0]*dims[1]*sizeof(T);
+  return true;
+}
+
+uint64_t geo::getMeshHash(void)
+{
+  uint64_t hash = fnv1a(&meshCacheVersion,sizeof(meshCacheVersion));
+
+  stringstream ss;
+  ss.precision(17);
+  ss << params->mesh_type << " " << params->periodicTol << " ";
+
+  if (params->mesh_type == READ_MESH) {
+    // Hash the full contents of the mesh file
+    int fd = open(params->meshFileName.c_str(), O_RDONLY);
+    if (fd < 0) FatalError("Unable to open mesh file.");
+    struct stat st;
+    fstat(fd, &st);
+    if (st.st_size > 0) {
+      void* fileMap = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (fileMap == MAP_FAILED) FatalError("Unable to memory-map mesh file.");
+      hash = fnv1a(fileMap, st.st_size, hash);
+      munmap(fileMap, st.st_size);
+    }
+    close(fd);
+
+    for (auto& bnd:params->meshBounds)
+      ss << bnd.first << " " << bnd.second << " ";
+  }
+  else {
+    ss << params->nDims << " " << params->nx << " " << params->ny << " ";
+    ss << params->xmin << " " << params->xmax << " " << params->ymin << " " << params->ymax << " ";
+    ss << params->create_bcTop << " " << params->create_bcBottom << " ";
+    ss << params->create_bcLeft << " " << params->create_bcRight;
+  }
+
+  string str = ss.str();
+  return fnv1a(str.data(), str.size(), hash);
+}
+
+void geo::writeMeshCache(string fileName, uint64_t hash)
+{
+  ofstream file(fileName.c_str(), ios::binary);
+  if (!file.is_open()) {
+    cout << "Geo: Unable to write mesh cache file " << fileName << endl;
+    return;
+  }
+
+  file.write(meshCacheMagic, 8);
+  file.write((const char*)&meshCacheVersion, sizeof(meshCacheVersion));
+  file.write((const char*)&hash, sizeof(hash));
+
+  int32_t counts[7] = {nDims, nEles, (int)xv.size(), nEdges, nFaces, nBndEdges, nBounds};
+  file.write((const char*)counts, sizeof(counts));
+  double periodic[2] = {params->periodicDX, params->periodicDY};
+  file.write((const char*)periodic, sizeof(periodic));
+
+  writeCacheData(file, xv.data(), xv.size());
+  writeCacheData(file, c2v);
+  writeCacheData(file, c2nv.data(), c2nv.size());
+  writeCacheData(file, c2ne.data(), c2ne.size());
+  writeCacheData(file, ctype.data(), ctype.size());
+  writeCacheData(file, e2v);
+  writeCacheData(file, e2c);
+  writeCacheData(file, c2e);
+  writeCacheData(file, c2b);
+  writeCacheData(file, e2lf);
+  writeCacheData(file, intEdges.data(), intEdges.size());
+  writeCacheData(file, bndEdges.data(), bndEdges.size());
+  writeCacheData(file, bcType.data(), bcType.size());
+
+  file.close();
+}
+
+bool geo::readMeshCache(string fileName, uint64_t hash)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  fstat(fd, &st);
+  size_t headerSize = 8 + sizeof(uint32_t) + sizeof(uint64_t);
+  if ((size_t)st.st_size < headerSize) {
+    close(fd);
+    return false;
+  }
+
+  void* fileMap = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (fileMap == MAP_FAILED) return false;
+
+  const char* p = (const char*)fileMap;
+  const char* end = p + st.st_size;
+
+  /* --- Validate the header: file type, layout version, and mesh/input hash --- */
+  uint32_t version;
+  uint64_t fileHash;
+  bool valid = (memcmp(p, meshCacheMagic, 8) == 0);
+  p += 8;
+  memcpy(&version, p, sizeof(version));  p += sizeof(version);
+  memcpy(&fileHash, p, sizeof(fileHash));  p += sizeof(fileHash);
+  valid = valid && (version == meshCacheVersion) && (fileHash == hash);
+
+  if (!valid) {
+    cout << "Geo: Mesh cache file " << fileName << " is out of date; regenerating." << endl;
+    munmap(fileMap, st.st_size);
+    return false;
+  }
+
+  /* --- Read the counts & arrays, checking every length against the bytes remaining --- */
+  int32_t counts[7];
+  double periodic[2];
+  valid = ((size_t)(end-p) >= sizeof(counts) + sizeof(periodic));
+  if (valid) {
+    memcpy(counts, p, sizeof(counts));  p += sizeof(counts);
+    memcpy(periodic, p, sizeof(periodic));  p += sizeof(periodic);
+  }
+
+  valid = valid && readCacheData(p, end, xv) && readCacheData(p, end, c2v)
+      && readCacheData(p, end, c2nv) && readCacheData(p, end, c2ne)
+      && readCacheData(p, end, ctype) && readCacheData(p, end, e2v)
+      && readCacheData(p, end, e2c) && readCacheData(p, end, c2e)
+      && readCacheData(p, end, c2b) && readCacheData(p, end, e2lf)
+      && readCacheData(p, end, intEdges) && readCacheData(p, end, bndEdges)
+      && readCacheData(p, end, bcType);
+
+  // The arrays must also agree with the counts, with nothing left over
+  valid = valid && p == end && counts[1] >= 0
+      && xv.size() == (size_t)counts[2] && c2v.getDim0() == (uint)counts[1]
+      && c2nv.size() == (size_t)counts[1] && c2ne.size() == (size_t)counts[1]
+      && ctype.size() == (size_t)counts[1] && c2e.getDim0() == (uint)counts[1]
+      && c2b.getDim0() == (uint)counts[1] && intEdges.size() == (size_t)counts[4]
+      && bndEdges.size() == (size_t)counts[5] && bcType.size() == (size_t)counts[5];
+
+  munmap(fileMap, st.st_size);
+
+  if (!valid) {
+    cout << "Geo: Mesh cache file " << fileName << " is truncated or corrupt; regenerating." << endl;
+    for (auto* mat:{&c2v, &e2v, &e2c, &c2e, &c2b, &e2lf}) mat->clear();
+    for (auto* vec:{&c2nv, &c2ne, &ctype, &intEdges, &bndEdges, &bcType}) vec->clear();
+    xv.clear();
+    return false;
+  }
+
+  nDims = counts[0];  nEles = counts[1];  nVerts = counts[2];  nEdges = counts[3];
+  nFaces = counts[4];  nBndEdges = counts[5];  nBounds = counts[6];
+  params->nDims = nDims;
+  params->periodicDX = periodic[0];
+  params->periodicDY = periodic[1];
+
+  return true;
+}
+
 bool geo::checkPeriodicFaces(int* edge1, int* edge2)
 {
   double x11, x12, y11, y12, x21, x22, y21, y22;
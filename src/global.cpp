@@ -18,6 +18,10 @@
 #include <cstdlib>
 #include <string>
 
+#if defined(_MIXED_PRECISION) && defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 /* --- Misc. Common Constants --- */
 double pi = 4.0*atan(1);
 
@@ -29,6 +33,14 @@ int factorial(int n)
 }
 
 void setGlobalVariables(void) {
+#if defined(_MIXED_PRECISION) && defined(__SSE__)
+  // Decaying single-precision data quickly becomes denormal, which is very slow on x86:
+  // flush denormals to zero on every thread
+#pragma omp parallel
+  _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+
+
   bcNum["none"] = NONE;
   bcNum["fluid"] = NONE;
   bcNum["periodic"] = PERIODIC;
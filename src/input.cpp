@@ -245,6 +245,7 @@ void input::readInputFile(char *filename)
     opts.getScalarValue("advectVx",advectVx,1.);
     opts.getScalarValue("advectVy",advectVy,1.);
     opts.getScalarValue("lambda",lambda,1.);
+    lowMachPrecon = 0;
     nFields = 1;
   } else if (equation==NAVIER_STOKES) {
     opts.getScalarValue("gamma",gamma,1.4);
@@ -258,6 +259,10 @@ void input::readInputFile(char *filename)
     opts.getScalarValue("TWall",TWall,300.);
     opts.getScalarValue("beta",beta,2.);
     opts.getScalarValue("slipPenalty",slipPenalty,false);
+    opts.getScalarValue("lowMachPrecon",lowMachPrecon,0);
+    if (lowMachPrecon)
+      opts.getScalarValue("precondEps",precondEps,0.5);
+    vMagInf = sqrt(uBound*uBound+vBound*vBound+wBound*wBound);
     if (ic_type == 0) {
       opts.getScalarValue("rhoIC",rhoIC,rhoBound);
       opts.getScalarValue("vxIC",vxIC,uBound);
@@ -271,12 +276,39 @@ void input::readInputFile(char *filename)
   opts.getScalarValue("viscous",viscous,0);
   opts.getScalarValue("motion",motion,0);
   opts.getScalarValue("order",order,3);
+  opts.getScalarValue("pSeq",pSeq,0);
+  if (pSeq) {
+    opts.getScalarValue("pSeqStart",pSeqStart,0);
+    opts.getScalarValue("pSeqResDrop",pSeqResDrop,1e-2);
+    opts.getScalarValue("pSeqScaleDt",pSeqScaleDt,1);
+  }
   opts.getScalarValue("riemann_type",riemann_type,0);
   opts.getScalarValue("test_case",test_case,0);
   opts.getScalarValue("iterMax",iterMax);
 
   opts.getScalarValue("timeType",timeType,0);
 
+  opts.getScalarValue("dualTime",dualTime,0);
+  if (dualTime) {
+    opts.getScalarValue("CFLtau",CFLtau,.5);
+    opts.getScalarValue("nInnerIters",nInnerIters,50);
+    opts.getScalarValue("innerTol",innerTol,1e-3);
+    if (motion) FatalError("Dual time stepping not supported with moving grids.");
+    if (pSeq) FatalError("Dual time stepping not compatible with p-sequencing.");
+  }
+
+  if (lowMachPrecon && (dualTime || motion))
+    FatalError("Low-Mach preconditioning is only valid for steady problems [no dualTime or motion].");
+
+  opts.getScalarValue("resSmooth",resSmooth,0);
+  if (resSmooth) {
+    opts.getScalarValue("resSmoothEps",resSmoothEps,0.5);
+    opts.getScalarValue("resSmoothIters",resSmoothIters,2);
+    // An odd # of Jacobi sweeps reverses the sign of the highest-frequency modes once resSmoothEps > 1/4
+    if (resSmoothIters < 2 || resSmoothIters%2)
+      FatalError("resSmoothIters must be a positive, even number.");
+  }
+
   opts.getScalarValue("restart",restart,0);
   if (restart) {
     opts.getScalarValue("restartIter",restartIter);
@@ -296,24 +328,57 @@ void input::readInputFile(char *filename)
     opts.getScalarValue("create_bcBottom",create_bcBottom,string("periodic"));
     opts.getScalarValue("create_bcLeft",create_bcLeft,string("periodic"));
     opts.getScalarValue("create_bcRight",create_bcRight,string("periodic"));
+    opts.getScalarValue("structuredMesh",structuredMesh,0);
+    if (structuredMesh && nDims != 2)
+      FatalError("Structured-mesh mode only available in 2D.");
   }else if (mesh_type == READ_MESH) {
     opts.getScalarValue("mesh_file_name",meshFileName);
     opts.getMap("mesh_bound",meshBounds);
+    structuredMesh = 0;
   }
   opts.getScalarValue("periodicTol",periodicTol,1e-6);
 
+  opts.getScalarValue("meshCache",meshCache,0);
+  if (meshCache) {
+    if (mesh_type == READ_MESH)
+      opts.getScalarValue("meshCacheFile",meshCacheFile,meshFileName+".cache");
+    else
+      opts.getScalarValue("meshCacheFile",meshCacheFile,string("flurryMesh.cache"));
+  }
+
+  opts.getScalarValue("leanMemory",leanMemory,0);
+
   opts.getScalarValue("monitor_res_freq",monitor_res_freq,10);
   opts.getScalarValue("resType",resType,2);
+  opts.getScalarValue("convResDrop",convResDrop,0.);
+  opts.getScalarValue("convStagWindow",convStagWindow,0);
+  if (convStagWindow)
+    opts.getScalarValue("convStagTol",convStagTol,1e-3);
   opts.getScalarValue("plot_freq",plot_freq,100);
   opts.getScalarValue("plot_type",plot_type,1);
   opts.getScalarValue("restart_freq",restart_freq,100);
   opts.getScalarValue("dataFileName",dataFileName,string("simData"));
+  opts.getScalarValue("refSolutionFile",refSolutionFile,string(""));
 
   opts.getScalarValue("spts_type_tri",sptsTypeTri,string("Legendre"));
   opts.getScalarValue("spts_type_quad",sptsTypeQuad,string("Legendre"));
   opts.getScalarValue("vcjhSchemeTri",vcjhSchemeTri,0);
   opts.getScalarValue("vcjhSchemeQuad",vcjhSchemeQuad,0);
 
+  opts.getScalarValue("denseOperators",denseOperators,0);
+
+  opts.getScalarValue("autotune",autotune,0);
+  if (autotune) {
+    opts.getScalarValue("autotuneReps",autotuneReps,10);
+    if (autotuneReps <= 0)
+      FatalError("autotuneReps must be positive.");
+    opts.getScalarValue("autotuneFile",autotuneFile,string("flurryTune.cache"));
+  }
+
+  opts.getScalarValue("operCache",operCache,0);
+  if (operCache)
+    opts.getScalarValue("operCacheDir",operCacheDir,string("."));
+
   /* --- Cleanup ---- */
   opts.closeFile();
 
@@ -325,4 +390,12 @@ void input::readInputFile(char *filename)
   }
 
   iter = initIter;
+
+  orderFinal = order;
+  dtFinal = dt;
+  if (pSeq) {
+    if (pSeqStart >= order)
+      FatalError("pSeqStart must be lower than the final polynomial order.");
+    order = pSeqStart;
+  }
 }
@@ -0,0 +1,182 @@
+/*!
+ * \file kernelGen.cpp
+ * \brief Generates unrolled, order-specialized C++ kernels for the FR operators
+ *
+ * Usage: kernelGen <outFile> <eType> <sptsType> <vcjhScheme> <order> [order ...]
+ *
+ * For each order, the spts->fpts extrapolation, gradient, divergence & correction
+ * operators are built exactly as in the solver, and written out as constexpr
+ * coefficient arrays with one fully-unrolled expression per output point (zero
+ * entries dropped).  Terms are summed in the same order as matrix::timesMatrix, so
+ * the generated kernels reproduce the dense operators to the last bit.
+ * Built & run automatically by 'make -f Makefile.flurry GENKERNELS=yes'.
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 0.0.1
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2014 Jacob Crabill.
+ *
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "../include/global.hpp"
+#include "../include/geo.hpp"
+#include "../include/input.hpp"
+#include "../include/operators.hpp"
+
+#ifdef _GENKERNELS
+// The solver objects linked into kernelGen reference the generated table; give them an empty one
+const genKernelSet genKernels[1] = {};
+const int nGenKernels = 0;
+#endif
+
+//! Write the coefficients of A as a constexpr array
+static void writeCoeffs(ostream &os, const string &name, matrix<flt> M)
+{
+  os << "  static constexpr flt " << name << "[" << M.getDim0() << "][" << M.getDim1() << "] = {" << endl;
+  for (uint i=0; i<M.getDim0(); i++) {
+    os << "    {";
+    for (uint j=0; j<M.getDim1(); j++) {
+      if (j > 0) os << ",";
+      if (M(i,j) == 0.) os << "0";
+      else os << M(i,j);
+    }
+    os << "}," << endl;
+  }
+  os << "  };" << endl;
+}
+
+//! Append the terms name[i][j]*u[j*nF] for all nonzero entries of row i of A
+static void writeRowTerms(ostream &os, const string &name, matrix<flt> &M, uint i, const string &u, bool &first)
+{
+  for (uint j=0; j<M.getDim1(); j++) {
+    if (M(i,j) == 0.) continue;
+    if (!first) os << " + ";
+    os << name << "[" << i << "][" << j << "]*" << u << "[" << j << "*nF]";
+    first = false;
+  }
+}
+
+//! Write the kernel B = A*U [or B += A*U if plus]
+static void writeProduct(ostream &os, const string &fName, matrix<flt> A, bool plus)
+{
+  os << "static void " << fName << "(const flt* __restrict__ U, flt* __restrict__ B, int nF)" << endl;
+  os << "{" << endl;
+  writeCoeffs(os,"A",A);
+  os << "  for (int k=0; k<nF; k++) {" << endl;
+  os << "    const flt* u = U+k;" << endl;
+  os << "    flt* b = B+k;" << endl;
+  for (uint i=0; i<A.getDim0(); i++) {
+    stringstream ss;
+    bool first = !plus;
+    if (plus) ss << "b[" << i << "*nF]";
+    writeRowTerms(ss,"A",A,i,"u",first);
+    if (plus && first) continue;  // Empty row: nothing to add
+    os << "    b[" << i << "*nF] = " << (first ? "0." : ss.str()) << ";" << endl;
+  }
+  os << "  }" << endl;
+  os << "}" << endl << endl;
+}
+
+//! Write the kernel B = sum_dim A[dim]*F[dim]
+static void writeDivergence(ostream &os, const string &fName, oper &op, uint nDims)
+{
+  os << "static void " << fName << "(const flt* const* F, flt* __restrict__ B, int nF)" << endl;
+  os << "{" << endl;
+  vector<matrix<flt>> A(nDims);
+  for (uint dim=0; dim<nDims; dim++) {
+    A[dim] = op.get_oper_grad_spts(dim);
+    writeCoeffs(os,"A"+to_string(dim),A[dim]);
+  }
+  os << "  for (int k=0; k<nF; k++) {" << endl;
+  for (uint dim=0; dim<nDims; dim++)
+    os << "    const flt* f" << dim << " = F[" << dim << "]+k;" << endl;
+  os << "    flt* b = B+k;" << endl;
+  uint nSpts = A[0].getDim0();
+  for (uint i=0; i<nSpts; i++) {
+    stringstream ss;
+    bool first = true;
+    for (uint dim=0; dim<nDims; dim++)
+      writeRowTerms(ss,"A"+to_string(dim),A[dim],i,"f"+to_string(dim),first);
+    os << "    b[" << i << "*nF] = " << (first ? "0." : ss.str()) << ";" << endl;
+  }
+  os << "  }" << endl;
+  os << "}" << endl << endl;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 6)
+    FatalError("Usage: kernelGen <outFile> <eType> <sptsType> <vcjhScheme> <order> [order ...]");
+
+  string outFile = argv[1];
+  int eType = atoi(argv[2]);
+  string sptsType = argv[3];
+  int vcjh = atoi(argv[4]);
+
+  if (eType != QUAD) FatalError("kernelGen currently supports only quadrilateral elements.");
+
+  setGlobalVariables();
+
+  input params;
+  params.nDims = 2;
+  params.nFields = 1;
+  params.sptsTypeQuad = params.sptsTypeTri = sptsType;
+  params.vcjhSchemeQuad = params.vcjhSchemeTri = vcjh;
+  params.denseOperators = 1;
+  params.operCache = 0;
+
+  geo Geo;
+  Geo.setupReference(&params);
+
+  stringstream body, table;
+  body << setprecision(17) << scientific;
+
+  int nSets = 0;
+  for (int arg=5; arg<argc; arg++) {
+    int order = atoi(argv[arg]);
+    oper op;
+    op.setupOperators(eType,order,&Geo,&params);
+
+    stringstream ss;
+    ss << "e" << eType << "_p" << order << "_" << sptsType << "_v" << vcjh;
+    string tag = ss.str();
+
+    writeProduct(body,"sptsFpts_"+tag,op.get_oper_spts_fpts(),false);
+    for (int dim=0; dim<params.nDims; dim++)
+      writeProduct(body,"grad"+to_string(dim)+"_"+tag,op.get_oper_grad_spts(dim),false);
+    writeDivergence(body,"divF_"+tag,op,params.nDims);
+    writeProduct(body,"correction_"+tag,op.get_oper_correction(),true);
+
+    table << "  {" << eType << ", " << params.nDims << ", " << order << ", \"" << sptsType << "\", " << vcjh << ",";
+    table << " sptsFpts_" << tag << ", {";
+    for (int dim=0; dim<3; dim++) {
+      if (dim > 0) table << ", ";
+      if (dim < params.nDims) table << "grad" << dim << "_" << tag;
+      else table << "NULL";
+    }
+    table << "}, divF_" << tag << ", correction_" << tag << "}," << endl;
+    nSets++;
+  }
+
+  ofstream file(outFile.c_str());
+  if (!file.is_open()) FatalError("Unable to open kernel output file.");
+
+  file << "// Generated by kernelGen:";
+  for (int arg=2; arg<argc; arg++) file << " " << argv[arg];
+  file << endl << "// Do not edit; re-run 'make -f Makefile.flurry GENKERNELS=yes' instead." << endl << endl;
+  file << "#include <cstddef>" << endl << endl;
+  file << "#include \"../include/genKernels.hpp\"" << endl << endl;
+  file << body.str();
+  file << "const genKernelSet genKernels[] = {" << endl << table.str() << "};" << endl << endl;
+  file << "const int nGenKernels = " << nSets << ";" << endl;
+
+  cout << "kernelGen: wrote " << nSets << " kernel set(s) to " << outFile << endl;
+}
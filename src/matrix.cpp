@@ -14,6 +14,10 @@
  */
 #include "../include/matrix.hpp"
 
+#ifdef _BLAS
+#include <cblas.h>
+#endif
+
 template<typename T>
 matrix<T>::matrix()
 {
@@ -55,6 +59,14 @@ void matrix<T>::setup(uint inDim0, uint inDim1)
   data.resize(inDim0*inDim1);
 }
 
+template<typename T>
+void matrix<T>::clear(void)
+{
+  dim0 = 0;
+  dim1 = 0;
+  vector<T>().swap(data);
+}
+
 template<typename T>
 void matrix<T>::addMatrix(matrix<T> &A, double a)
 {
@@ -159,6 +171,51 @@ void matrix<T>::timesVector(vector<T> &A, vector<T> &B)
   }
 }
 
+#ifdef _BLAS
+// Route floating-point products to the system CBLAS dgemm/sgemm; all other types use the loops above
+template<>
+void matrix<double>::timesMatrix(matrix<double> &A, matrix<double> &B)
+{
+  if (A.dim0 != dim1) FatalError("Incompatible matrix sizes in matrix multiplication!");
+  if (B.dim0 != dim0 || B.dim1 != A.dim1) B.setup(dim0, A.dim1);
+
+  cblas_dgemm(CblasRowMajor,CblasNoTrans,CblasNoTrans,dim0,A.dim1,dim1,
+              1.0,data.data(),dim1,A.data.data(),A.dim1,0.0,B.data.data(),B.dim1);
+}
+
+template<>
+void matrix<double>::timesMatrixPlus(matrix<double> &A, matrix<double> &B)
+{
+  if (A.dim0 != dim1) FatalError("Incompatible matrix sizes in matrix multiplication!");
+  if (B.dim0 != dim0 || B.dim1 != A.dim1) B.setup(dim0, A.dim1);
+
+  cblas_dgemm(CblasRowMajor,CblasNoTrans,CblasNoTrans,dim0,A.dim1,dim1,
+              1.0,data.data(),dim1,A.data.data(),A.dim1,1.0,B.data.data(),B.dim1);
+}
+
+#ifdef _MIXED_PRECISION
+template<>
+void matrix<float>::timesMatrix(matrix<float> &A, matrix<float> &B)
+{
+  if (A.dim0 != dim1) FatalError("Incompatible matrix sizes in matrix multiplication!");
+  if (B.dim0 != dim0 || B.dim1 != A.dim1) B.setup(dim0, A.dim1);
+
+  cblas_sgemm(CblasRowMajor,CblasNoTrans,CblasNoTrans,dim0,A.dim1,dim1,
+              1.0f,data.data(),dim1,A.data.data(),A.dim1,0.0f,B.data.data(),B.dim1);
+}
+
+template<>
+void matrix<float>::timesMatrixPlus(matrix<float> &A, matrix<float> &B)
+{
+  if (A.dim0 != dim1) FatalError("Incompatible matrix sizes in matrix multiplication!");
+  if (B.dim0 != dim0 || B.dim1 != A.dim1) B.setup(dim0, A.dim1);
+
+  cblas_sgemm(CblasRowMajor,CblasNoTrans,CblasNoTrans,dim0,A.dim1,dim1,
+              1.0f,data.data(),dim1,A.data.data(),A.dim1,1.0f,B.data.data(),B.dim1);
+}
+#endif
+#endif
+
 // Support for non-arithematic data types (pointers) - do nothing.
 template<>
 void matrix<double*>::addMatrix(matrix<double*> &, double ) {
@@ -183,6 +240,28 @@ void matrix<double*>::timesVector(vector<double*> &, vector<double*> &) {
   FatalError("matrix.timesVector not supported for non-arithematic data types.");
 }
 
+#ifdef _MIXED_PRECISION
+template<>
+void matrix<float*>::addMatrix(matrix<float*> &, double ) {
+  FatalError("matrix.addMatrix not supported for non-arithematic data types.");
+}
+
+template<>
+void matrix<float*>::timesMatrix(matrix<float*> &, matrix<float*> &) {
+  FatalError("matrix.timesMatrix not supported for non-arithematic data types.");
+}
+
+template<>
+void matrix<float*>::timesMatrixPlus(matrix<float*> &, matrix<float*> &) {
+  FatalError("matrix.timesMatrixPlus not supported for non-arithematic data types.");
+}
+
+template<>
+void matrix<float*>::timesVector(vector<float*> &, vector<float*> &) {
+  FatalError("matrix.timesVector not supported for non-arithematic data types.");
+}
+#endif
+
 template<typename T>
 void matrix<T>::insertRow(vector<T> &vec, int rowNum)
 {
@@ -303,3 +382,7 @@ vector<T> matrix<T>::getData(void)
 template class matrix<int>;
 template class matrix<double>;
 template class matrix<double*>;
+#ifdef _MIXED_PRECISION
+template class matrix<float>;
+template class matrix<float*>;
+#endif
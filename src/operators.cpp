@@ -13,7 +13,12 @@
 
 #include "../include/operators.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
 
 #include "../include/polynomials.hpp"
  
@@ -29,46 +34,332 @@ void oper::setupOperators(uint eType, uint order, geo *inGeo, input *inParams)
   this->eType = eType;
   this->order = order;
 
-  vector<point> loc_spts = Geo->getLocSpts(eType,order);
-  vector<point> loc_fpts = Geo->getLocFpts(eType,order);
+  string cacheFile;
+  if (params->operCache) cacheFile = getCacheFileName();
 
-  // Set up each operator
-  setupExtrapolateSptsFpts(loc_spts, loc_fpts);
+  if (!params->operCache || !readCache(cacheFile)) {
+    vector<point> loc_spts = Geo->getLocSpts(eType,order);
+    vector<point> loc_fpts = Geo->getLocFpts(eType,order);
 
-  setupExtrapolateSptsMpts(loc_spts);
+    // Set up each operator
+    setupExtrapolateSptsFpts(loc_spts, loc_fpts);
 
-  setupGradSpts(loc_spts);
+    setupExtrapolateSptsMpts(loc_spts);
 
-  setupCorrection(loc_spts,loc_fpts);
+    setupGradSpts(loc_spts);
 
+    setupCorrection(loc_spts,loc_fpts);
+
+    if (params->operCache) writeCache(cacheFile);
+  }
+
+  setupOperatorStructure();
+}
+
+//! If every row of A has a single entry of exactly 1 (all others 0), get the column of each row's 1
+static bool getInjection(matrix<flt> &A, vector<int> &idx)
+{
+  idx.assign(A.getDim0(),-1);
+  for (uint i=0; i<A.getDim0(); i++) {
+    for (uint j=0; j<A.getDim1(); j++) {
+      if (A(i,j) == 0.) continue;
+      if (A(i,j) != 1. || idx[i] != -1) {
+        idx.clear();
+        return false;
+      }
+      idx[i] = j;
+    }
+    if (idx[i] == -1) {
+      idx.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void oper::setupOperatorStructure(void)
+{
+  sptsFptsIdx.clear();
+  sptsMptsIdx.clear();
+  sptsFptsLines = lineOper();
+  corrLines = lineOper();
+  gradLines.clear();
+  genSet = NULL;
+
+  kernels.fill(DENSE_KERNEL);
+
+  if (params->denseOperators) return;
+
+  getInjection(opp_spts_to_fpts,sptsFptsIdx);
+  getInjection(opp_spts_to_mpts,sptsMptsIdx);
+
+  if (eType == QUAD) {
+    // Each fpt depends only on the line of spts normal to its face, & each fpt's correction
+    // only affects that same line; d/dxi & d/deta each couple only points on one line
+    uint n1D = order+1;
+    sptsFptsLines.setup(opp_spts_to_fpts,n1D);
+
+    corrLines.setup(opp_correction,n1D,true);
+
+    gradLines.resize(nDims);
+    for (uint dim=0; dim<nDims; dim++) {
+      if (!gradLines[dim].setup(opp_grad_spts[dim],n1D)) {
+        gradLines.clear();
+        break;
+      }
+    }
+  }
+
+  setupGenKernels();
+
+  // Default to the most specialized kernel available
+  for (int op=0; op<3; op++)
+    kernels[op] = getKernels(op).back();
+}
+
+vector<int> oper::getKernels(int operType)
+{
+  vector<int> out = {DENSE_KERNEL};
+
+  switch (operType) {
+    case OPER_SPTS_FPTS:
+      if (!sptsFptsLines.empty()) out.push_back(LINE_KERNEL);
+      if (!sptsFptsIdx.empty()) out.push_back(INJECT_KERNEL);
+      if (genSet) out.push_back(GEN_KERNEL);
+      break;
+    case OPER_GRAD:
+      if (!gradLines.empty()) out.push_back(LINE_KERNEL);
+      if (genSet) out.push_back(GEN_KERNEL);
+      break;
+    case OPER_CORRECTION:
+      if (!corrLines.empty()) out.push_back(LINE_KERNEL);
+      if (genSet) out.push_back(GEN_KERNEL);
+      break;
+    default:
+      FatalError("Unknown operator type.");
+  }
+
+  return out;
+}
+
+void oper::setKernel(int operType, int kernel)
+{
+  vector<int> avail = getKernels(operType);
+  if (std::find(avail.begin(),avail.end(),kernel) == avail.end())
+    FatalError("Requested kernel not available for this operator.");
+
+  kernels[operType] = kernel;
+}
+
+//! Apply a generated kernel: B = A*U, with A of size nRows x U.getDim0()
+static void applyGenKernel(genKernelFn kernel, matrix<flt> &U, matrix<flt> &B, uint nRows)
+{
+  uint nCols = U.getDim1();
+  if (B.getDim0() != nRows || B.getDim1() != nCols) B.setup(nRows,nCols);
+
+  kernel(U[0],B[0],nCols);
+}
+
+#ifdef _GENKERNELS
+//! Largest difference between a generated kernel's output & the reference, relative to the reference
+static double genKernelError(matrix<flt> &ref, matrix<flt> &out)
+{
+  double err = 0;
+  for (uint i=0; i<ref.getDim0(); i++)
+    for (uint k=0; k<ref.getDim1(); k++)
+      err = max(err, std::abs(ref(i,k)-out(i,k))/(1.+std::abs(ref(i,k))));
+
+  return err;
+}
+#endif
+
+void oper::setupGenKernels(void)
+{
+#ifdef _GENKERNELS
+  string ptsType = (eType == QUAD) ? params->sptsTypeQuad : params->sptsTypeTri;
+  int vcjh = (eType == QUAD) ? params->vcjhSchemeQuad : params->vcjhSchemeTri;
+
+  for (int i=0; i<nGenKernels; i++) {
+    const genKernelSet &g = genKernels[i];
+    if (g.eType == (int)eType && g.nDims == (int)nDims && g.order == (int)order
+        && ptsType == g.sptsType && g.vcjhScheme == vcjh) {
+      genSet = &g;
+      break;
+    }
+  }
+
+  if (!genSet) return;
+
+  // Guard against stale generated code: compare each kernel to the operator matrices on arbitrary data
+  uint nSpts = opp_spts_to_fpts.getDim1();
+  uint nFpts = opp_spts_to_fpts.getDim0();
+  matrix<flt> U(nSpts,nFields), Fn(nFpts,nFields), ref, out;
+  for (uint i=0; i<nSpts; i++)
+    for (uint k=0; k<nFields; k++)
+      U(i,k) = sin(1.+i*nFields+k);
+  for (uint i=0; i<nFpts; i++)
+    for (uint k=0; k<nFields; k++)
+      Fn(i,k) = cos(1.+i*nFields+k);
+
+  double err = 0;
+  opp_spts_to_fpts.timesMatrix(U,ref);
+  applyGenKernel(genSet->sptsFpts,U,out,nFpts);
+  err = max(err,genKernelError(ref,out));
+
+  const flt* F[3];
+  ref.setup(nSpts,nFields);
+  ref.initializeToZero();
+  for (uint dim=0; dim<nDims; dim++) {
+    opp_grad_spts[dim].timesMatrixPlus(U,ref);
+    F[dim] = U[0];
+  }
+  out.setup(nSpts,nFields);
+  genSet->divF(F,out[0],nFields);
+  err = max(err,genKernelError(ref,out));
+
+  for (uint dim=0; dim<nDims; dim++) {
+    opp_grad_spts[dim].timesMatrix(U,ref);
+    applyGenKernel(genSet->grad[dim],U,out,nSpts);
+    err = max(err,genKernelError(ref,out));
+  }
+
+  ref = U;
+  out = U;
+  opp_correction.timesMatrixPlus(Fn,ref);
+  genSet->correction(Fn[0],out[0],nFields);
+  err = max(err,genKernelError(ref,out));
+
+  if (err > 1e4*numeric_limits<flt>::epsilon()) {
+    cout << "WARNING: Generated kernels for eType " << eType << ", p=" << order << " do not match the operators";
+    cout << " [error " << err << "]; re-run kernelGen.  Not using them." << endl;
+    genSet = NULL;
+  }
+#endif
+}
+
+bool lineOper::setup(matrix<flt> &A, uint nPts1D, bool transpose)
+{
+  uint nRows = (transpose) ? A.getDim1() : A.getDim0();
+  uint nCols = (transpose) ? A.getDim0() : A.getDim1();
+  auto val = [&](uint i, uint j) { return (transpose) ? A(j,i) : A(i,j); };
+
+  start.assign(nRows,0);
+  stride.assign(nRows,1);
+  wts.setup(nRows,nPts1D);
+  wts.initializeToZero();
+
+  if (nCols != nPts1D*nPts1D) {
+    start.clear();
+    return false;
+  }
+
+  for (uint i=0; i<nRows; i++) {
+    // Check whether all nonzeros share a row (j/nPts1D) or a column (j%nPts1D) of points
+    int row = -1, col = -1;
+    bool sameRow = true, sameCol = true;
+    for (uint j=0; j<nCols; j++) {
+      if (val(i,j) == 0.) continue;
+      if (row == -1) {
+        row = j/nPts1D;
+        col = j%nPts1D;
+      }
+      sameRow = sameRow && ((int)(j/nPts1D) == row);
+      sameCol = sameCol && ((int)(j%nPts1D) == col);
+    }
+
+    if (row == -1) continue;  // Empty row
+
+    if (sameRow) {
+      start[i] = row*nPts1D;
+      stride[i] = 1;
+    }
+    else if (sameCol) {
+      start[i] = col;
+      stride[i] = nPts1D;
+    }
+    else {
+      start.clear();
+      stride.clear();
+      wts.clear();
+      return false;
+    }
+
+    for (uint m=0; m<nPts1D; m++)
+      wts(i,m) = val(i,start[i]+m*stride[i]);
+  }
+
+  return true;
+}
+
+void lineOper::apply(matrix<flt> &U, matrix<flt> &B, bool add)
+{
+  uint nRows = start.size();
+  uint nPts1D = wts.getDim1();
+  uint nCols = U.getDim1();
+  if (!add && (B.getDim0() != nRows || B.getDim1() != nCols)) B.setup(nRows,nCols);
+
+  for (uint i=0; i<nRows; i++) {
+    flt* b = B[i];
+    if (!add)
+      for (uint k=0; k<nCols; k++) b[k] = 0.;
+
+    for (uint m=0; m<nPts1D; m++) {
+      flt a = wts(i,m);
+      flt* u = U[start[i]+m*stride[i]];
+      for (uint k=0; k<nCols; k++)
+        b[k] += a*u[k];
+    }
+  }
+}
+
+void lineOper::applyTransposePlus(matrix<flt> &U, matrix<flt> &B)
+{
+  uint nRows = start.size();
+  uint nPts1D = wts.getDim1();
+  uint nCols = U.getDim1();
+
+  for (uint i=0; i<nRows; i++) {
+    flt* u = U[i];
+    for (uint m=0; m<nPts1D; m++) {
+      flt a = wts(i,m);
+      flt* b = B[start[i]+m*stride[i]];
+      for (uint k=0; k<nCols; k++)
+        b[k] += a*u[k];
+    }
+  }
 }
 
 void oper::setupExtrapolateSptsFpts(vector<point> &loc_spts, vector<point> &loc_fpts)
 {
-  uint spt, fpt, nSpts, nFpts, ispt, jspt;
-  nSpts = loc_spts.size();
-  nFpts = loc_fpts.size();
+  uint nSpts = loc_spts.size();
+  uint nFpts = loc_fpts.size();
 
   opp_spts_to_fpts.setup(nFpts,nSpts);
 
-  for (fpt=0; fpt<nFpts; fpt++) {
-    for (spt=0; spt<nSpts; spt++) {
-      switch(eType) {
-        case(TRI):
+  switch(eType) {
+    case(TRI):
+      for (uint fpt=0; fpt<nFpts; fpt++)
+        for (uint spt=0; spt<nSpts; spt++)
           opp_spts_to_fpts[fpt][spt] = eval_dubiner_basis_2d(loc_fpts[fpt],spt,order);
-          break;
-        case(QUAD): {
-          vector<double> locSpts1D = Geo->getPts1D(params->sptsTypeQuad,order);
-          // First, get the i an j ID of the spt
-          ispt = spt%(nSpts/(order+1));
-          jspt = floor(spt/(order+1));
-          opp_spts_to_fpts[fpt][spt] = Lagrange(locSpts1D,loc_fpts[fpt].x,ispt) * Lagrange(locSpts1D,loc_fpts[fpt].y,jspt);
-          break;
-        }
-        default:
-          FatalError("Element type not yet supported.");
+      break;
+
+    case(QUAD): {
+      // Tensor product of the 1D Lagrange bases in each direction
+      vector<double> locSpts1D = Geo->getPts1D(params->sptsTypeQuad,order);
+      vector<double> w = getBarycentricWeights(locSpts1D);
+      vector<double> lagX(order+1), lagY(order+1);
+      for (uint fpt=0; fpt<nFpts; fpt++) {
+        LagrangeBasis(locSpts1D,w,loc_fpts[fpt].x,lagX.data());
+        LagrangeBasis(locSpts1D,w,loc_fpts[fpt].y,lagY.data());
+        for (uint spt=0; spt<nSpts; spt++)
+          opp_spts_to_fpts[fpt][spt] = lagX[spt%(order+1)] * lagY[spt/(order+1)];
       }
+      break;
     }
+
+    default:
+      FatalError("Element type not yet supported.");
   }
 }
 
@@ -91,18 +382,22 @@ void oper::setupExtrapolateSptsMpts(vector<point> &loc_spts)
       break;
     }
     case(QUAD): {
-      uint ispt, jspt;
       opp_spts_to_mpts.setup(4,nSpts);
       vector<double> locSpts1D = Geo->getPts1D(params->sptsTypeQuad,order);
+      vector<double> w = getBarycentricWeights(locSpts1D);
+      // 1D Lagrange bases evaluated at -1 and +1
+      vector<double> lagM(order+1), lagP(order+1);
+      LagrangeBasis(locSpts1D,w,-1.,lagM.data());
+      LagrangeBasis(locSpts1D,w, 1.,lagP.data());
       for (uint spt=0; spt<nSpts; spt++) {
         // First, get the i an j ID of the spt
-        ispt = spt%(nSpts/(order+1));
-        jspt = floor(spt/(order+1));
+        uint ispt = spt%(order+1);
+        uint jspt = spt/(order+1);
         // Next, get evaluate Lagrange solution basis at corners
-        opp_spts_to_mpts[0][spt] = Lagrange(locSpts1D,-1,ispt) * Lagrange(locSpts1D,-1,jspt);
-        opp_spts_to_mpts[1][spt] = Lagrange(locSpts1D, 1,ispt) * Lagrange(locSpts1D,-1,jspt);
-        opp_spts_to_mpts[2][spt] = Lagrange(locSpts1D, 1,ispt) * Lagrange(locSpts1D, 1,jspt);
-        opp_spts_to_mpts[3][spt] = Lagrange(locSpts1D,-1,ispt) * Lagrange(locSpts1D, 1,jspt);
+        opp_spts_to_mpts[0][spt] = lagM[ispt] * lagM[jspt];
+        opp_spts_to_mpts[1][spt] = lagP[ispt] * lagM[jspt];
+        opp_spts_to_mpts[2][spt] = lagP[ispt] * lagP[jspt];
+        opp_spts_to_mpts[3][spt] = lagM[ispt] * lagP[jspt];
       }
       break;
     }
@@ -111,13 +406,13 @@ void oper::setupExtrapolateSptsMpts(vector<point> &loc_spts)
   }
 }
 
-void oper::setupInterpolate(vector<point> &pts_from, vector<point> &pts_to, matrix<double> &opp_interp)
+void oper::setupInterpolate(vector<point> &pts_from, vector<point> &pts_to, matrix<flt> &opp_interp)
 {
   uint ptA, ptB, nPtsFrom, nPtsTo, pt, iptA, jptA;
   nPtsFrom = pts_from.size();
   nPtsTo = pts_to.size();
 
-  opp_interp.setup(nPtsFrom,nPtsTo);
+  opp_interp.setup(nPtsTo,nPtsFrom);
 
   // Get 1D locations of points for arbitrary, potentially anisotropic tensor-product elements
   vector<double> locPts1Dx, locPts1Dy;
@@ -130,29 +425,35 @@ void oper::setupInterpolate(vector<point> &pts_from, vector<point> &pts_to, matr
     }
   }
 
-  for (ptB=0; ptB<nPtsTo; ptB++) {
-    for (ptA=0; ptA<nPtsFrom; ptA++) {
-      switch(eType) {
-        case(TRI):
-          opp_interp[ptB][ptA] = eval_dubiner_basis_2d(pts_to[ptB],ptA,order);
-          break;
-        case(QUAD):
-          // First, get the i and j ID of the pt [tensor-product element]
-          iptA = ptA%(nPtsFrom/(order+1));
-          jptA = floor(ptA/(order+1));
-          opp_interp[ptB][ptA] = Lagrange(locPts1Dx,pts_to[ptB].x,iptA) * Lagrange(locPts1Dy,pts_to[ptB].y,jptA);
-          break;
-        default:
-          FatalError("Element type not yet supported.");
+  if (eType==TRI) {
+    for (ptB=0; ptB<nPtsTo; ptB++)
+      for (ptA=0; ptA<nPtsFrom; ptA++)
+        opp_interp[ptB][ptA] = eval_dubiner_basis_2d(pts_to[ptB],ptA,order);
+  }
+  else if (eType==QUAD) {
+    vector<double> wx = getBarycentricWeights(locPts1Dx);
+    vector<double> wy = getBarycentricWeights(locPts1Dy);
+    vector<double> lagX(order+1), lagY(order+1);
+    for (ptB=0; ptB<nPtsTo; ptB++) {
+      LagrangeBasis(locPts1Dx,wx,pts_to[ptB].x,lagX.data());
+      LagrangeBasis(locPts1Dy,wy,pts_to[ptB].y,lagY.data());
+      for (ptA=0; ptA<nPtsFrom; ptA++) {
+        // First, get the i and j ID of the pt [tensor-product element]
+        iptA = ptA%(order+1);
+        jptA = ptA/(order+1);
+        opp_interp[ptB][ptA] = lagX[iptA] * lagY[jptA];
       }
     }
   }
+  else {
+    FatalError("Element type not yet supported.");
+  }
 }
 
 void oper::setupGradSpts(vector<point> &loc_spts)
 {
-  uint nSpts, spt1, spt2, dim;
-  uint xid1, yid1, xid2, yid2;
+  uint nSpts, spt1, spt2;
+  uint xid1, yid1;
   nSpts = loc_spts.size();
 
   opp_grad_spts.resize(nDims);
@@ -167,20 +468,21 @@ void oper::setupGradSpts(vector<point> &loc_spts)
     }
   }
   else if (eType == QUAD) {
+    // 1D differentiation matrix: dLag[i][j] = l_j'(x_i)
     vector<double> loc_spts_1D = Geo->getPts1D(params->sptsTypeQuad,order);
-    for (dim=0; dim<nDims; dim++) {
-      for (spt1=0; spt1<nSpts; spt1++) {
-        xid1 = spt1%(nSpts/(order+1));      // col index - also = to (spt1 - (order+1)*row)
-        yid1 = floor(spt1/(order+1));       // row index
-        for (spt2=0; spt2<nSpts; spt2++) {
-          xid2 = spt2%(nSpts/(order+1));
-          yid2 = floor(spt2/(order+1));
-          if (dim==0) {
-            opp_grad_spts[dim][spt1][spt2] = dLagrange(loc_spts_1D,loc_spts_1D[xid1],xid2) * Lagrange(loc_spts_1D,loc_spts_1D[yid1],yid2);
-          } else {
-            opp_grad_spts[dim][spt1][spt2] = dLagrange(loc_spts_1D,loc_spts_1D[yid1],yid2) * Lagrange(loc_spts_1D,loc_spts_1D[xid1],xid2);
-          }
-        }
+    vector<double> w = getBarycentricWeights(loc_spts_1D);
+    matrix<double> dLag(order+1,order+1);
+    for (uint i=0; i<order+1; i++)
+      dLagrangeBasis(loc_spts_1D,w,loc_spts_1D[i],dLag[i]);
+
+    for (auto& dim:opp_grad_spts) dim.initializeToZero();
+    for (spt1=0; spt1<nSpts; spt1++) {
+      xid1 = spt1%(order+1);      // col index
+      yid1 = spt1/(order+1);      // row index
+      for (uint k=0; k<order+1; k++) {
+        // d/dx couples only points in the same row; d/dy only those in the same column
+        opp_grad_spts[0][spt1][yid1*(order+1)+k] = dLag[xid1][k];
+        opp_grad_spts[1][spt1][k*(order+1)+xid1] = dLag[yid1][k];
       }
     }
   }
@@ -192,8 +494,7 @@ void oper::setupGradSpts(vector<point> &loc_spts)
 
 void oper::setupCorrection(vector<point> &loc_spts, vector<point> &loc_fpts)
 {
-  uint nSpts, nFpts, spt, fpt, dim;
-  vector<double> loc(nDims);
+  uint nSpts, nFpts;
   nSpts = loc_spts.size();
   nFpts = loc_fpts.size();
 
@@ -204,172 +505,290 @@ void oper::setupCorrection(vector<point> &loc_spts, vector<point> &loc_fpts)
     // Not yet implemented
   }
   else if (eType == QUAD) {
+    uint vcjh = params->vcjhSchemeQuad;
+    double eta = (vcjh == DG) ? 0. : compute_eta(vcjh,order);
+
     vector<double> loc_spts_1D = Geo->getPts1D(params->sptsTypeQuad,order);
-    for(spt=0; spt<nSpts; spt++) {
-      for(dim=0; dim<nDims; dim++){
-        loc[dim] = loc_spts[spt][dim];
-      }
+    vector<double> w = getBarycentricWeights(loc_spts_1D);
+
+    // 1D tables: Lagrange bases & left/right correction-function derivatives at the spts
+    uint n1D = order+1;
+    matrix<double> lag(n1D,n1D);
+    vector<double> dgL(n1D), dgR(n1D);
+    for (uint i=0; i<n1D; i++) {
+      LagrangeBasis(loc_spts_1D,w,loc_spts_1D[i],lag[i]);
+      dgL[i] = dVCJH_1d(loc_spts_1D[i],0,order,eta);
+      dgR[i] = dVCJH_1d(loc_spts_1D[i],1,order,eta);
+    }
 
-      for(fpt=0; fpt<nFpts; fpt++) {
-        opp_correction[spt][fpt] = divVCJH_quad(fpt,loc,loc_spts_1D,params->vcjhSchemeQuad,order);
+    for (uint spt=0; spt<nSpts; spt++) {
+      uint ix = spt%n1D;
+      uint iy = spt/n1D;
+      for (uint j=0; j<n1D; j++) {
+        opp_correction[spt][j]        = -lag[ix][j] * dgL[iy];         // Face 0 (bottom)
+        opp_correction[spt][j+n1D]    =  lag[iy][j] * dgR[ix];         // Face 1 (right)
+        opp_correction[spt][j+2*n1D]  =  lag[ix][order-j] * dgR[iy];   // Face 2 (top)
+        opp_correction[spt][j+3*n1D]  = -lag[iy][order-j] * dgL[ix];   // Face 3 (left)
       }
     }
   }
 }
 
-//void oper::setupGradCorrection(vector<point> &loc_spts, vector<point> &loc_fpts)
-//{
-//  uint nSpts, nFpts, spt, fpt, dim;
-//  vector<double> loc(nDims);
-//  nSpts = loc_spts.size();
-//  nFpts = loc_fpts.size();
-
-//  opp_grad_correction.setup(nSpts,nFpts);
-//  opp_grad_correction.initializeToZero();
-
-//  if (eType == TRI) {
-//    // Not yet implemented
-//  }
-//  else if (eType == QUAD) {
-//    vector<double> loc_spts_1D = Geo->getPts1D(params->sptsTypeQuad,order);
-//    for(spt=0; spt<nSpts; spt++) {
-//      for(dim=0; dim<nDims; dim++){
-//        loc[dim] = loc_spts[spt][dim];
-//      }
-
-//      for(fpt=0; fpt<nFpts; fpt++) {
-//        opp_grad_correction[dim][spt][fpt] = divVCJH_quad(fpt,loc,loc_spts_1D,params->vcjhSchemeQuad,order);
-//      }
-//    }
-//  }
-//}
-
-
-void oper::applyGradSpts(matrix<double> &U_spts, vector<matrix<double> > &dU_spts)
+void oper::applyGradSpts(matrix<flt> &U_spts, vector<matrix<flt> > &dU_spts)
 {
-  for (uint dim=0; dim<nDims; dim++)
-    opp_grad_spts[dim].timesMatrix(U_spts,dU_spts[dim]);
+  for (uint dim=0; dim<nDims; dim++) {
+    if (kernels[OPER_GRAD] == GEN_KERNEL)
+      applyGenKernel(genSet->grad[dim],U_spts,dU_spts[dim],opp_grad_spts[dim].getDim0());
+    else if (kernels[OPER_GRAD] == LINE_KERNEL)
+      gradLines[dim].apply(U_spts,dU_spts[dim],false);
+    else
+      opp_grad_spts[dim].timesMatrix(U_spts,dU_spts[dim]);
+  }
 }
 
-void oper::applyGradFSpts(vector<matrix<double>> &F_spts, vector<vector<matrix<double>>> &dF_spts)
+void oper::applyGradFSpts(vector<matrix<flt>> &F_spts, vector<vector<matrix<flt>>> &dF_spts)
 {
   // Note: dim1 is flux direction, dim2 is derivative direction
-  for (uint dim1=0; dim1<nDims; dim1++)
-    for (uint dim2=0; dim2<dF_spts.size(); dim2++)
-      opp_grad_spts[dim2].timesMatrix(F_spts[dim1],dF_spts[dim2][dim1]);
+  for (uint dim1=0; dim1<nDims; dim1++) {
+    for (uint dim2=0; dim2<dF_spts.size(); dim2++) {
+      if (kernels[OPER_GRAD] == GEN_KERNEL)
+        applyGenKernel(genSet->grad[dim2],F_spts[dim1],dF_spts[dim2][dim1],opp_grad_spts[dim2].getDim0());
+      else if (kernels[OPER_GRAD] == LINE_KERNEL)
+        gradLines[dim2].apply(F_spts[dim1],dF_spts[dim2][dim1],false);
+      else
+        opp_grad_spts[dim2].timesMatrix(F_spts[dim1],dF_spts[dim2][dim1]);
+    }
+  }
 }
 
 
-void oper::applyDivFSpts(vector<matrix<double>> &F_spts, matrix<double> &divF_spts)
+void oper::applyDivFSpts(vector<matrix<flt>> &F_spts, matrix<flt> &divF_spts)
 {
+  if (kernels[OPER_GRAD] == GEN_KERNEL) {
+    const flt* F[3];
+    for (uint dim=0; dim<nDims; dim++) F[dim] = F_spts[dim][0];
+    genSet->divF(F,divF_spts[0],F_spts[0].getDim1());
+    return;
+  }
+
   divF_spts.initializeToZero();
-  for (uint dim=0; dim<nDims; dim++)
+  for (uint dim=0; dim<nDims; dim++) {
+    if (kernels[OPER_GRAD] == LINE_KERNEL)
+      gradLines[dim].apply(F_spts[dim],divF_spts,true);
+    else
       opp_grad_spts[dim].timesMatrixPlus(F_spts[dim],divF_spts);
+  }
 }
 
 
-void oper::applySptsFpts(matrix<double> &U_spts, matrix<double> &U_fpts)
+//! Gather rows of A into B according to the given injection [B(i,:) = A(idx[i],:)]
+static void applyInjection(vector<int> &idx, matrix<flt> &A, matrix<flt> &B)
 {
-  opp_spts_to_fpts.timesMatrix(U_spts,U_fpts);
+  uint nCols = A.getDim1();
+  if (B.getDim0() != idx.size() || B.getDim1() != nCols) B.setup(idx.size(),nCols);
+
+  for (uint i=0; i<idx.size(); i++) {
+    flt* a = A[idx[i]];
+    flt* b = B[i];
+    for (uint k=0; k<nCols; k++) b[k] = a[k];
+  }
 }
 
-void oper::applySptsMpts(matrix<double> &U_spts, matrix<double> &U_mpts)
+void oper::extrapolateSptsFpts(matrix<flt> &U_spts, matrix<flt> &U_fpts)
 {
-  opp_spts_to_mpts.timesMatrix(U_spts,U_mpts);
+  switch (kernels[OPER_SPTS_FPTS]) {
+    case GEN_KERNEL:
+      applyGenKernel(genSet->sptsFpts,U_spts,U_fpts,opp_spts_to_fpts.getDim0());
+      break;
+    case INJECT_KERNEL:
+      applyInjection(sptsFptsIdx,U_spts,U_fpts);
+      break;
+    case LINE_KERNEL:
+      sptsFptsLines.apply(U_spts,U_fpts,false);
+      break;
+    default:
+      opp_spts_to_fpts.timesMatrix(U_spts,U_fpts);
+  }
+}
+
+void oper::applySptsFpts(matrix<flt> &U_spts, matrix<flt> &U_fpts)
+{
+  extrapolateSptsFpts(U_spts,U_fpts);
 }
 
-void oper::applyExtrapolateFn(vector<matrix<double>> &F_spts, matrix<double> &tnorm_fpts, matrix<double> &Fn_fpts)
+void oper::applySptsMpts(matrix<flt> &U_spts, matrix<flt> &U_mpts)
+{
+  if (!sptsMptsIdx.empty())
+    applyInjection(sptsMptsIdx,U_spts,U_mpts);
+  else
+    opp_spts_to_mpts.timesMatrix(U_spts,U_mpts);
+}
+
+void oper::applyExtrapolateFn(vector<matrix<flt>> &F_spts, matrix<double> &tnorm_fpts, matrix<flt> &Fn_fpts)
 {
   uint nFpts = tnorm_fpts.getDim0();
-  matrix<double> tempFn(nFpts,nDims);
+
+  if (kernels[OPER_SPTS_FPTS] == INJECT_KERNEL) {
+    // Flux points collocated with solution points: gather directly
+    for (uint fpt=0; fpt<nFpts; fpt++) {
+      int spt = sptsFptsIdx[fpt];
+      for (uint i=0; i<nFields; i++) {
+        Fn_fpts[fpt][i] = 0.;
+        for (uint dim=0; dim<nDims; dim++)
+          Fn_fpts[fpt][i] += F_spts[dim][spt][i]*tnorm_fpts[fpt][dim];
+      }
+    }
+    return;
+  }
+
+  matrix<flt> tempFn(nFpts,nDims);
   tempFn.initializeToZero();
   Fn_fpts.initializeToZero();
 
   for (uint dim=0; dim<nDims; dim++) {
-    opp_spts_to_fpts.timesMatrix(F_spts[dim],tempFn);
+    extrapolateSptsFpts(F_spts[dim],tempFn);
     for (uint fpt=0; fpt<nFpts; fpt++)
       for (uint i=0; i<nFields; i++)
         Fn_fpts[fpt][i] += tempFn[fpt][i]*tnorm_fpts[fpt][dim];
   }
 }
 
-void oper::applyExtrapolateFn(vector<matrix<double>> &F_spts, matrix<double> &norm_fpts, matrix<double> &Fn_fpts, vector<double>& dA_fpts)
+void oper::applyExtrapolateFn(vector<matrix<flt>> &F_spts, matrix<double> &norm_fpts, matrix<flt> &Fn_fpts, vector<double>& dA_fpts)
 {
   uint nFpts = norm_fpts.getDim0();
-  matrix<double> tempFn(nFpts,nDims);
+
+  if (kernels[OPER_SPTS_FPTS] == INJECT_KERNEL) {
+    // Flux points collocated with solution points: gather directly
+    for (uint fpt=0; fpt<nFpts; fpt++) {
+      int spt = sptsFptsIdx[fpt];
+      for (uint i=0; i<nFields; i++) {
+        Fn_fpts[fpt][i] = 0.;
+        for (uint dim=0; dim<nDims; dim++)
+          Fn_fpts[fpt][i] += F_spts[dim][spt][i]*norm_fpts[fpt][dim]*dA_fpts[fpt];
+      }
+    }
+    return;
+  }
+
+  matrix<flt> tempFn(nFpts,nDims);
   tempFn.initializeToZero();
   Fn_fpts.initializeToZero();
 
   for (uint dim=0; dim<nDims; dim++) {
-    opp_spts_to_fpts.timesMatrix(F_spts[dim],tempFn);
+    extrapolateSptsFpts(F_spts[dim],tempFn);
     for (uint fpt=0; fpt<nFpts; fpt++)
       for (uint i=0; i<nFields; i++)
         Fn_fpts[fpt][i] += tempFn[fpt][i]*norm_fpts[fpt][dim]*dA_fpts[fpt];
   }
 }
 
-void oper::applyCorrectDivF(matrix<double> &dFn_fpts, matrix<double> &divF_spts)
+void oper::applyCorrectDivF(matrix<flt> &dFn_fpts, matrix<flt> &divF_spts)
 {
-  opp_correction.timesMatrixPlus(dFn_fpts,divF_spts);
+  if (kernels[OPER_CORRECTION] == GEN_KERNEL)
+    genSet->correction(dFn_fpts[0],divF_spts[0],dFn_fpts.getDim1());
+  else if (kernels[OPER_CORRECTION] == LINE_KERNEL)
+    corrLines.applyTransposePlus(dFn_fpts,divF_spts);
+  else
+    opp_correction.timesMatrixPlus(dFn_fpts,divF_spts);
 }
 
 
-const matrix<double> &oper::get_oper_div_spts()
+const matrix<flt> &oper::get_oper_div_spts()
 {
   return opp_div_spts;
 }
 
+const matrix<flt> &oper::get_oper_spts_fpts()
+{
+  return opp_spts_to_fpts;
+}
 
-double oper::divVCJH_quad(int in_fpt, vector<double>& loc, vector<double>& loc_1d_spts, uint vcjh, uint order)
+const matrix<flt> &oper::get_oper_grad_spts(int dim)
 {
-  uint i,j;
-  double eta;
-  double div_vcjh_basis = 0;
+  return opp_grad_spts[dim];
+}
 
-  if (vcjh == DG)
-    eta = 0.; // HiFiLES: run_input.eta_quad;
-  else
-    eta = compute_eta(vcjh,order);
+const matrix<flt> &oper::get_oper_correction()
+{
+  return opp_correction;
+}
 
-  i = in_fpt / (order+1);      // Face upon which the flux point lies [0,1,2, or 3]
-  j = in_fpt - (order+1)*i;    // Face-local index of flux point [0 to n_fpts_per_face-1]
 
-  if(i==0)
-    div_vcjh_basis = -Lagrange(loc_1d_spts,loc[0],j) * dVCJH_1d(loc[1],0,order,eta); // was -'ve
-  else if(i==1)
-    div_vcjh_basis =  Lagrange(loc_1d_spts,loc[1],j) * dVCJH_1d(loc[0],1,order,eta);
-  else if(i==2)
-    div_vcjh_basis =  Lagrange(loc_1d_spts,loc[0],order-j) * dVCJH_1d(loc[1],1,order,eta);
-  else if(i==3)
-    div_vcjh_basis =-Lagrange(loc_1d_spts,loc[1],order-j) * dVCJH_1d(loc[0],0,order,eta); // was -'ve
+/* ---- On-disk operator cache ---- */
 
+//! Version of the operator-cache file layout; increment whenever the layout or operator definitions change
+static const uint32_t operCacheVersion = 1;
+static const char operCacheMagic[8] = {'F','L','R','Y','O','P','E','R'};
 
-  return div_vcjh_basis;
+string oper::getCacheFileName(void)
+{
+  string ptsType = (eType == QUAD) ? params->sptsTypeQuad : params->sptsTypeTri;
+  int vcjh = (eType == QUAD) ? params->vcjhSchemeQuad : params->vcjhSchemeTri;
+
+  stringstream ss;
+  ss << params->operCacheDir << "/flurryOper_e" << eType << "_d" << nDims << "_p" << order;
+  ss << "_" << ptsType << "_vcjh" << vcjh;
+  if (sizeof(flt) != sizeof(double)) ss << "_sp";
+  ss << ".cache";
+  return ss.str();
 }
 
-//double oper::dVCJH_quad(int fpt, int dim, vector<double>& loc, vector<double>& loc_1d_spts, uint vcjh, uint order)
-//{
-//  uint i,j;
-//  double eta;
-//  double div_vcjh_basis;
+void oper::writeCache(string fileName)
+{
+  ofstream file(fileName.c_str(), ios::binary);
+  if (!file.is_open()) {
+    cout << "Operators: Unable to write operator cache file " << fileName << endl;
+    return;
+  }
+
+  file.write(operCacheMagic, 8);
+  file.write((const char*)&operCacheVersion, sizeof(operCacheVersion));
 
-//  if (vcjh == DG)
-//    eta = 0.; // HiFiLES: run_input.eta_quad;
-//  else
-//    eta = compute_eta(vcjh,order);
+  vector<matrix<flt>*> mats = {&opp_spts_to_fpts, &opp_spts_to_mpts, &opp_correction};
+  for (auto& mat:opp_grad_spts) mats.push_back(&mat);
 
-//  i = fpt / (order+1);      // Face upon which the flux point lies [0,1,2, or 3]
-//  j = fpt - (order+1)*i;    // Face-local index of flux point [0 to n_fpts_per_face-1]
+  uint32_t nMats = mats.size();
+  file.write((const char*)&nMats, sizeof(nMats));
+  for (auto* mat:mats) {
+    uint32_t dims[2] = {mat->getDim0(), mat->getDim1()};
+    file.write((const char*)dims, sizeof(dims));
+    if (dims[0]*dims[1] > 0) file.write((const char*)(*mat)[0], dims[0]*dims[1]*sizeof(flt));
+  }
+
+  file.close();
+}
+
+bool oper::readCache(string fileName)
+{
+  ifstream file(fileName.c_str(), ios::binary);
+  if (!file.is_open()) return false;
+
+  char magic[8];
+  uint32_t version, nMats;
+  file.read(magic, 8);
+  file.read((char*)&version, sizeof(version));
+  file.read((char*)&nMats, sizeof(nMats));
+  if (!file || memcmp(magic, operCacheMagic, 8) != 0 || version != operCacheVersion || nMats != 3+nDims) {
+    cout << "Operators: Cache file " << fileName << " is out of date; regenerating." << endl;
+    return false;
+  }
 
-//  if(i==0)
-//    div_vcjh_basis = -Lagrange(loc_1d_spts,loc[0],j) * dVCJH_1d(loc[1],0,order,eta); // was -'ve
-//  else if(i==1)
-//    div_vcjh_basis =  Lagrange(loc_1d_spts,loc[1],j) * dVCJH_1d(loc[0],1,order,eta);
-//  else if(i==2)
-//    div_vcjh_basis =  Lagrange(loc_1d_spts,loc[0],order-j) * dVCJH_1d(loc[1],1,order,eta);
-//  else if(i==3)
-//    div_vcjh_basis =-Lagrange(loc_1d_spts,loc[1],order-j) * dVCJH_1d(loc[0],0,order,eta); // was -'ve
+  opp_grad_spts.resize(nDims);
+  vector<matrix<flt>*> mats = {&opp_spts_to_fpts, &opp_spts_to_mpts, &opp_correction};
+  for (auto& mat:opp_grad_spts) mats.push_back(&mat);
+
+  for (auto* mat:mats) {
+    uint32_t dims[2];
+    file.read((char*)dims, sizeof(dims));
+    if (!file) return false;
+    mat->setup(dims[0],dims[1]);
+    if (dims[0]*dims[1] > 0) file.read((char*)(*mat)[0], dims[0]*dims[1]*sizeof(flt));
+  }
 
+  if (!file) {
+    cout << "Operators: Cache file " << fileName << " is truncated; regenerating." << endl;
+    return false;
+  }
 
-//  return div_vcjh_basis;
-//}
+  return true;
+}
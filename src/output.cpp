@@ -15,6 +15,7 @@
 #include "../include/output.hpp"
 
 #include <iomanip>
+#include <sstream>
 
 void writeData(solver *Solver, input *params)
 {
@@ -100,12 +101,12 @@ void writeParaview(solver *Solver, input *params)
   dataFile << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\" compressor=\"vtkZLibDataCompressor\">" << endl;
   dataFile << "	<UnstructuredGrid>" << endl;
 
-  for (auto& e:Solver->eles) {
-    // If this is the initial file, need to extrapolate solution to flux points
-    if (params->iter==0) Solver->extrapolateU();
+  // If this is the initial file, need to extrapolate solution to flux points
+  if (params->iter==0) Solver->extrapolateU();
 
-    Solver->extrapolateUMpts();
+  Solver->extrapolateUMpts();
 
+  for (auto& e:Solver->eles) {
     if (params->motion != 0) {
       e.updatePosSpts();
       e.updatePosFpts();
@@ -116,7 +117,8 @@ void writeParaview(solver *Solver, input *params)
     matrix<double> vPpts, gridVelPpts;
     vector<point> ppts;
     e.getPrimitivesPlot(vPpts);
-    e.getGridVelPlot(gridVelPpts);
+    if (params->motion)
+      e.getGridVelPlot(gridVelPpts);
     ppts = e.getPpts();
 
     int nSubCells = (e.order+2)*(e.order+2);
@@ -259,29 +261,54 @@ void writeParaview(solver *Solver, input *params)
 }
 
 
-void writeResidual(solver *Solver, input *params)
+void compareSolution(solver *Solver, input *params)
 {
-  vector<double> res(params->nFields), resTmp(params->nFields);
-  int iter = params->iter;
+  ifstream refFile(params->refSolutionFile.c_str());
+  if (!refFile.is_open()) {
+    cout << "Unable to open reference solution " << params->refSolutionFile << endl;
+    return;
+  }
+
+  int nFields = params->nFields;
+  vector<double> errL2(nFields,0), errInf(nFields,0);
+  int nPts = 0;
+
+  string line, val;
+  getline(refFile,line); // Header
 
   for (auto& e:Solver->eles) {
-    resTmp = e.getResidual(params->resType);
-    if(checkNaN(resTmp)) FatalError("NaN Encountered in Solution Residual!");
-
-    for (int i=0; i<params->nFields; i++) {
-      if (params->resType == 3) {
-        // Infinity norm [max residual over all spts]
-        res[i] = max(res[i],resTmp[i]);
-      }else{
-        res[i] += resTmp[i];
+    for (uint spt=0; spt<e.getNSpts(); spt++) {
+      if (!getline(refFile,line)) FatalError("Reference solution has fewer points than the current solution.");
+
+      // Skip the x,y,z coordinates
+      stringstream ss(line);
+      for (int i=0; i<3; i++) getline(ss,val,',');
+
+      vector<double> V = e.getPrimitives(spt);
+      for (int i=0; i<nFields; i++) {
+        getline(ss,val,',');
+        double diff = abs(V[i] - atof(val.c_str()));
+        errL2[i] += diff*diff;
+        errInf[i] = max(errInf[i],diff);
       }
+      nPts++;
     }
   }
 
-  // If taking 2-norm, res is sum squared; take sqrt to complete
-  if (params->resType == 2) {
-    for (auto& i:res) i = sqrt(i);
-  }
+  cout.precision(4);
+  cout.setf(ios::scientific, ios::floatfield);
+  cout << "Difference from reference solution " << params->refSolutionFile << " [" << nPts << " points]:" << endl;
+  cout << "  L2:  ";
+  for (int i=0; i<nFields; i++) cout << " " << sqrt(errL2[i]/nPts);
+  cout << endl << "  Inf: ";
+  for (int i=0; i<nFields; i++) cout << " " << errInf[i];
+  cout << endl;
+}
+
+vector<double> writeResidual(solver *Solver, input *params)
+{
+  vector<double> res = Solver->getResidualNorm(params->resType);
+  int iter = params->iter;
 
   int colW = 16;
   cout.precision(8);
@@ -305,4 +332,6 @@ void writeResidual(solver *Solver, input *params)
     cout << setw(colW) << left << res[i];
   }
   cout << endl;
+
+  return res;
 }
@@ -101,16 +101,124 @@ double ddLagrange(vector<double> &x_lag, double y, uint mode)
   return ddLag;
 }
 
-double Legendre(double in_r, int in_mode)
+vector<double> getBarycentricWeights(vector<double> &x_lag)
 {
-  double leg = 0.;
+  uint n = x_lag.size();
+  vector<double> w(n,1.);
 
-  if(in_mode==0) {
-    leg = 1.0;
-  } else if(in_mode==1) {
-    leg = in_r;
-  } else {
-    leg = ((2*in_mode-1)*in_r*Legendre(in_r,in_mode-1)-(in_mode-1)*Legendre(in_r,in_mode-2)) / in_mode;
+  for (uint j=0; j<n; j++) {
+    for (uint k=0; k<n; k++) {
+      if (k!=j) w[j] *= (x_lag[j]-x_lag[k]);
+    }
+    w[j] = 1./w[j];
+  }
+
+  return w;
+}
+
+void LagrangeBasis(vector<double> &x_lag, vector<double> &w, double y, double* out)
+{
+  uint n = x_lag.size();
+
+  // At one of the points, the basis is exactly the Kronecker delta
+  for (uint j=0; j<n; j++) {
+    if (y == x_lag[j]) {
+      for (uint k=0; k<n; k++) out[k] = 0.;
+      out[j] = 1.;
+      return;
+    }
+  }
+
+  // 'First form' of the barycentric formula: l_j(y) = l(y) * w_j / (y - x_j)
+  double l = 1.;
+  for (uint k=0; k<n; k++) l *= (y-x_lag[k]);
+
+  for (uint j=0; j<n; j++)
+    out[j] = l*w[j]/(y-x_lag[j]);
+}
+
+void dLagrangeBasis(vector<double> &x_lag, vector<double> &w, double y, double* out)
+{
+  uint n = x_lag.size();
+
+  for (uint i=0; i<n; i++) {
+    if (y == x_lag[i]) {
+      // At point i: use the differentiation-matrix entries
+      out[i] = 0.;
+      for (uint j=0; j<n; j++) {
+        if (j==i) continue;
+        out[j] = (w[j]/w[i])/(x_lag[i]-x_lag[j]);
+        out[i] += 1./(x_lag[i]-x_lag[j]);
+      }
+      return;
+    }
+  }
+
+  // Away from the points: l_j'(y) = l_j(y) * sum_{k!=j} 1/(y - x_k)
+  LagrangeBasis(x_lag,w,y,out);
+  double sum = 0.;
+  for (uint k=0; k<n; k++) sum += 1./(y-x_lag[k]);
+  for (uint j=0; j<n; j++)
+    out[j] *= sum - 1./(y-x_lag[j]);
+}
+
+vector<double> getGaussLegendrePts(int nPts)
+{
+  vector<double> pts(nPts);
+
+  // Roots of P_n are symmetric about 0; find the positive half by Newton iteration
+  for (int i=0; i<(nPts+1)/2; i++) {
+    double x = cos(pi*(i+0.75)/(nPts+0.5));
+    for (int iter=0; iter<100; iter++) {
+      double dx = Legendre(x,nPts)/dLegendre(x,nPts);
+      x -= dx;
+      if (fabs(dx) < 1e-15) break;
+    }
+    pts[nPts-1-i] =  x;
+    pts[i]        = -x;
+  }
+
+  if (nPts%2 == 1) pts[nPts/2] = 0.;
+
+  return pts;
+}
+
+vector<double> getGaussLobattoPts(int nPts)
+{
+  if (nPts == 1) return vector<double>(1,0.);
+
+  vector<double> pts(nPts);
+  int N = nPts-1;
+
+  // Newton iteration on (1-x^2)P'_N(x), starting from the Chebyshev-Gauss-Lobatto points
+  for (int i=0; i<(nPts+1)/2; i++) {
+    double x = cos(pi*i/N);
+    for (int iter=0; iter<100; iter++) {
+      double PN = Legendre(x,N);
+      double dx = (x*PN - Legendre(x,N-1)) / ((N+1)*PN);
+      x -= dx;
+      if (fabs(dx) < 1e-15) break;
+    }
+    pts[nPts-1-i] =  x;
+    pts[i]        = -x;
+  }
+
+  if (nPts%2 == 1) pts[nPts/2] = 0.;
+
+  return pts;
+}
+
+double Legendre(double in_r, int in_mode)
+{
+  if (in_mode==0) return 1.0;
+
+  // Three-term recurrence: n P_n = (2n-1) r P_(n-1) - (n-1) P_(n-2)
+  double legm1 = 1.0;
+  double leg = in_r;
+  for (int n=2; n<=in_mode; n++) {
+    double legm2 = legm1;
+    legm1 = leg;
+    leg = ((2*n-1)*in_r*legm1-(n-1)*legm2) / n;
   }
 
   return leg;
@@ -15,7 +15,16 @@
 
 #include "../include/solver.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#ifdef _OPENMP
 #include <omp.h>
+#endif
+
+#include "../include/flux.hpp"
+#include "../include/physics.hpp"
 
 solver::solver()
 {
@@ -34,8 +43,18 @@ void solver::setup(input *params, geo *Geo)
   /* Setup the FR operators for computation */
   setupOperators();
 
+  /* Group the boundary faces by boundary condition */
+  setupBoundGroups();
+
+  if (params->resSmooth) setupResidualSmoothing();
+
   /* Additional Setup */
 
+  if (params->pSeq) setPSeqTimeStep();
+
+  // Connectivity is still needed if the elements will be re-setup at a higher order
+  if (params->leanMemory && params->order == params->orderFinal) releaseSetupData();
+
   // Time advancement setup
   switch (params->timeType) {
     case 0:
@@ -50,9 +69,42 @@ void solver::setup(input *params, geo *Geo)
     default:
       FatalError("Time-Stepping type not supported.");
   }
+
+  // Select the physics-specialized kernels once, rather than branching at every point
+  if (params->nDims != 2)
+    FatalError("Only 2D physics is currently implemented.");
+
+  switch (params->equation) {
+    case ADVECTION_DIFFUSION:
+      updateRKPhysics = &solver::updateRK<AdvectionDiffusion>;
+      break;
+    case NAVIER_STOKES:
+      updateRKPhysics = &solver::updateRK<Euler2D>;
+      break;
+    default:
+      FatalError("Equation type not recognized.");
+  }
+
+  reportMemory();
 }
 
 void solver::update(void)
+{
+  if (params->dualTime)
+    updateDualTime();
+  else
+    updateRK();
+
+  params->time += params->dt;
+}
+
+void solver::updateRK(void)
+{
+  (this->*updateRKPhysics)();
+}
+
+template<class Physics>
+void solver::updateRK(void)
 {
   if (nRKSteps>1)
     copyUspts_U0();
@@ -61,51 +113,103 @@ void solver::update(void)
 
   for (int step=0; step<nRKSteps-1; step++) {
 
-    if (step == 1)
+    if (params->dualTime)
+      params->rkTime = params->time + params->dt;
+    else if (step == 1)
       params->rkTime = params->time;
     else
       params->rkTime = params->time + RKa[step-1]*params->dt;
 
     moveMesh(step);
 
-    calcResidual(step);
+    calcResidual<Physics>(step);
+
+    if (step == 0) storeResidualNorm();
+
+    if (params->lowMachPrecon) preconditionResidual<Physics>(step);
 
-    timeStepA(step);
+    if (params->resSmooth) smoothResidual(step);
+
+    timeStepA<Physics>(step);
 
   }
 
   /* Final Runge-Kutta time advancement step */
 
-  if (nRKSteps == 1)
+  if (nRKSteps == 1 && !params->dualTime)
     params->rkTime = params->time;
   else
     params->rkTime = params->time + params->dt;
 
   moveMesh(nRKSteps-1);
 
-  calcResidual(nRKSteps-1);
+  calcResidual<Physics>(nRKSteps-1);
+
+  if (nRKSteps == 1) storeResidualNorm();
+
+  if (params->lowMachPrecon) preconditionResidual<Physics>(nRKSteps-1);
+
+  if (params->resSmooth) smoothResidual(nRKSteps-1);
 
   if (nRKSteps>1)
     copyU0_Uspts();
 
   for (int step=0; step<nRKSteps; step++) {
-    timeStepB(step);
+    timeStepB<Physics>(step);
   }
+}
 
-  params->time += params->dt;
+void solver::updateDualTime(void)
+{
+  /* Store the solution at the previous physical time levels */
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    eles[i].shiftTimeLevels();
+  }
+
+  /* Converge the pseudo-time problem for U^{n+1} */
+  vector<double> res0;
+  for (int iter=0; iter<params->nInnerIters; iter++) {
+
+#pragma omp parallel for
+    for (uint i=0; i<eles.size(); i++) {
+      eles[i].calcDtau();
+    }
+
+    updateRK();
+
+    // Residual at the first RK stage of this pseudo-iteration, incl. the physical source term
+    vector<double> res = getResidualNorm(params->resType);
+    if (iter == 0) {
+      res0 = res;
+      continue;
+    }
+
+    bool converged = true;
+    for (int i=0; i<params->nFields; i++) {
+      if (res0[i] > 0 && res[i] > params->innerTol*res0[i]) {
+        converged = false;
+        break;
+      }
+    }
+    if (converged) break;
+  }
+
+  nDualSteps++;
 }
 
+template<class Physics>
 void solver::calcResidual(int step)
 {
   extrapolateU();
 
-  calcInviscidFlux_spts();
+  calcInviscidFlux_spts<Physics>();
 
   extrapolateNormalFlux();
 
-  calcInviscidFlux_faces();
+  calcInviscidFlux_faces<Physics>();
 
-  calcInviscidFlux_bounds();
+  calcInviscidFlux_bounds<Physics>();
 
   if (params->viscous || params->motion) {
 
@@ -128,21 +232,32 @@ void solver::calcResidual(int step)
   calcFluxDivergence(step);
 
   correctDivFlux(step);
+
+  if (params->dualTime) {
+    // Physical time derivative (BDF2; BDF1 for the first physical time step)
+    int bdfOrder = (nDualSteps == 0) ? 1 : 2;
+#pragma omp parallel for
+    for (uint i=0; i<eles.size(); i++) {
+      eles[i].addPhysicalSource(step,bdfOrder);
+    }
+  }
 }
 
+template<class Physics>
 void solver::timeStepA(int step)
 {
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
-    eles[i].timeStepA(step,RKa[step]);
+    eles[i].timeStepA<Physics>(step,RKa[step]);
   }
 }
 
+template<class Physics>
 void solver::timeStepB(int step)
 {
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
-    eles[i].timeStepB(step,RKb[step]);
+    eles[i].timeStepB<Physics>(step,RKb[step]);
   }
 }
 
@@ -174,39 +289,126 @@ void solver::extrapolateUMpts(void)
 {
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
+    // Only needed for output, so not allocated until first used
+    if (eles[i].U_mpts.getDim0() == 0) eles[i].U_mpts.setup(eles[i].nNodes,eles[i].nFields);
     opers[eles[i].eType][eles[i].order].applySptsMpts(eles[i].U_spts,eles[i].U_mpts);
   }
 }
 
+template<class Physics>
 void solver::calcInviscidFlux_spts(void)
 {
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
-    eles[i].calcInviscidFlux_spts();
+    eles[i].calcInviscidFlux_spts<Physics>();
   }
 }
 
+template<class Physics>
 void solver::calcInviscidFlux_faces()
 {
+  if (params->structuredMesh) {
+    calcInviscidFlux_structured<Physics>();
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<faces.size(); i++) {
-    faces[i].calcInviscidFlux();
+    faces[i].calcInviscidFlux<Physics>();
   }
 }
 
+template<class Physics>
+void solver::calcInviscidFlux_structured(void)
+{
+  int nx = params->nx;
+  int ny = params->ny;
+  int nxFaces = (Geo->periodicX) ? nx : nx-1;
+  int nyFaces = (Geo->periodicY) ? ny : ny-1;
+
+#pragma omp parallel
+  {
+    // i-lines: right face of cell (i,j) / left face of cell (i+1,j)
+#pragma omp for
+    for (int i=0; i<nxFaces; i++) {
+      int ip = (i+1)%nx;
+      for (int j=0; j<ny; j++)
+        calcStructuredFaceFlux<Physics>(eles[i*ny+j],eles[ip*ny+j],1,3);
+    }
+
+    // j-lines: top face of cell (i,j) / bottom face of cell (i,j+1)
+#pragma omp for
+    for (int i=0; i<nx; i++) {
+      for (int j=0; j<nyFaces; j++)
+        calcStructuredFaceFlux<Physics>(eles[i*ny+j],eles[i*ny+(j+1)%ny],2,0);
+    }
+  }
+}
+
+template<class Physics>
+void solver::calcStructuredFaceFlux(ele &eL, ele &eR, int locFL, int locFR)
+{
+  const int nF = Physics::nFields;
+  double tempUL[nF], tempUR[nF], Fn[nF];
+
+  int nFptsFace = eL.order+1;
+  for (int k=0; k<nFptsFace; k++) {
+    int fL = locFL*nFptsFace + k;
+    int fR = (locFR+1)*nFptsFace - 1 - k;
+
+    double* uL = getDouble(eL.U_fpts[fL],nF,tempUL);
+    double* uR = getDouble(eR.U_fpts[fR],nF,tempUR);
+
+    Physics::interfaceFlux(uL, uR, eL.norm_fpts[fL], Fn, params);
+
+    flt* dFnL = eL.dFn_fpts[fL];
+    flt* dFnR = eR.dFn_fpts[fR];
+    const flt* FnL = eL.Fn_fpts[fL];
+    const flt* FnR = eR.Fn_fpts[fR];
+    for (int j=0; j<nF; j++) {
+      dFnL[j] =  Fn[j]*eL.dA_fpts[fL] - FnL[j];
+      dFnR[j] = -Fn[j]*eR.dA_fpts[fR] - FnR[j];
+    }
+  }
+}
+
+template<class Physics>
 void solver::calcInviscidFlux_bounds()
 {
-#pragma omp parallel for
+  for (uint g=0; g<bcGroupType.size(); g++) {
+    bound::calcInviscidFluxGroup<Physics>(bounds,bcGroupStart[g],bcGroupStart[g+1],bcGroupType[g],bcRef);
+  }
+}
+
+void solver::setupBoundGroups(void)
+{
+  bcRef.setup(params);
+
+  // Sort the boundary faces by BC type [stable, to keep the mesh ordering within each group]
+  stable_sort(bounds.begin(),bounds.end(),[](const bound &a, const bound &b) {
+    return a.getBcType() < b.getBcType();
+  });
+
+  bcGroupType.clear();
+  bcGroupStart.clear();
   for (uint i=0; i<bounds.size(); i++) {
-    bounds[i].calcInviscidFlux();
+    int bc = bounds[i].getBcType();
+    if (i > 0 && bc == bcGroupType.back()) continue;
+
+    if (bc == SUB_IN_CHAR || bc == SUB_OUT_CHAR || bc == PERIODIC || bc == NONE)
+      FatalError("Boundary condition not implemented.");
+
+    bcGroupType.push_back(bc);
+    bcGroupStart.push_back(i);
   }
+  bcGroupStart.push_back(bounds.size());
 }
 
 void solver::calcViscousFlux_spts(void)
 {
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
-    eles[i].calcInviscidFlux_spts();
+    eles[i].calcViscousFlux_spts();
   }
 }
 
@@ -319,6 +521,105 @@ void solver::moveMesh(int step)
   }
 }
 
+template<class Physics>
+void solver::preconditionResidual(int step)
+{
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    eles[i].preconditionResidual<Physics>(step);
+  }
+}
+
+void solver::setupResidualSmoothing(void)
+{
+  // Solution point adjacent to point p (counter-clockwise) of local face f of a quad
+  auto faceSpt = [](int f, int p, int n1D) {
+    switch (f) {
+      case 0:  return p;
+      case 1:  return (p+1)*n1D - 1;
+      case 2:  return n1D*n1D - 1 - p;
+      default: return (n1D-1-p)*n1D;
+    }
+  };
+
+  sptStart.assign(eles.size()+1,0);
+  for (uint i=0; i<eles.size(); i++) {
+    if (eles[i].eType != QUAD)
+      FatalError("Residual smoothing is only implemented for quadrilateral elements.");
+    sptStart[i+1] = sptStart[i] + eles[i].nSpts;
+  }
+
+  vector<vector<int>> nbs(sptStart.back());
+  matrix<int> &c2c = Geo->c2c;
+  for (uint ic=0; ic<eles.size(); ic++) {
+    int n1D = eles[ic].order+1;
+    int s0 = sptStart[ic];
+
+    // Tensor-product neighbors within the element
+    for (int spt=0; spt<eles[ic].nSpts; spt++) {
+      int ix = spt%n1D;
+      int iy = spt/n1D;
+      if (ix > 0)     nbs[s0+spt].push_back(s0+spt-1);
+      if (ix < n1D-1) nbs[s0+spt].push_back(s0+spt+1);
+      if (iy > 0)     nbs[s0+spt].push_back(s0+spt-n1D);
+      if (iy < n1D-1) nbs[s0+spt].push_back(s0+spt+n1D);
+    }
+
+    // Facing point across each interior face [the neighbor traverses the shared face in reverse]
+    for (int f=0; f<4; f++) {
+      int nb = c2c[ic][f];
+      if (nb < 0 || eles[nb].order != eles[ic].order) continue;
+      int fNb = Geo->getNbLocalFace(ic,f);
+      if (fNb < 0) continue;
+      for (int p=0; p<n1D; p++)
+        nbs[s0+faceSpt(f,p,n1D)].push_back(sptStart[nb]+faceSpt(fNb,n1D-1-p,n1D));
+    }
+  }
+
+  smoothNbStart.assign(nbs.size()+1,0);
+  smoothNbs.resize(0);
+  for (uint p=0; p<nbs.size(); p++) {
+    smoothNbs.insert(smoothNbs.end(),nbs[p].begin(),nbs[p].end());
+    smoothNbStart[p+1] = smoothNbs.size();
+  }
+
+  resSmooth0.setup(sptStart.back(),params->nFields);
+  resSmoothNew.setup(sptStart.back(),params->nFields);
+  resSmoothOld.setup(sptStart.back(),params->nFields);
+}
+
+void solver::smoothResidual(int step)
+{
+  int nFields = params->nFields;
+  double eps = params->resSmoothEps;
+
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    eles[i].getPhysResidual(step,resSmooth0[sptStart[i]]);
+  }
+
+  /* --- Jacobi sweeps on (1 + eps*nNbs)*Rs_p - eps*sum(Rs_nb) = R_p [all solution points] --- */
+  resSmoothNew = resSmooth0;
+  for (int iter=0; iter<params->resSmoothIters; iter++) {
+    resSmoothOld = resSmoothNew;
+#pragma omp parallel for
+    for (int p=0; p<sptStart.back(); p++) {
+      int nNbs = smoothNbStart[p+1] - smoothNbStart[p];
+      for (int k=0; k<nFields; k++) {
+        double resSum = 0;
+        for (int j=smoothNbStart[p]; j<smoothNbStart[p+1]; j++)
+          resSum += resSmoothOld[smoothNbs[j]][k];
+        resSmoothNew[p][k] = (resSmooth0[p][k] + eps*resSum) / (1. + eps*nNbs);
+      }
+    }
+  }
+
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    eles[i].setPhysResidual(step,resSmoothNew[sptStart[i]]);
+  }
+}
+
 void solver::setupOperators()
 {
   // Get all element types & olynomial orders in mesh
@@ -327,11 +628,144 @@ void solver::setupOperators()
     polyOrders[e.eType].insert(e.order);
   }
 
+  // Only setup operators which don't yet exist (i.e. after a change of order)
   for (auto& e: eTypes) {
     for (auto& p: polyOrders[e]) {
-      opers[e][p].setupOperators(e,p,Geo,params);
+      if (!opers[e].count(p)) {
+        opers[e][p].setupOperators(e,p,Geo,params);
+        if (params->autotune) autotuneOperators(e,p);
+      }
+    }
+  }
+}
+
+//! Names of each operator [OPER_TYPE] and kernel [OPER_KERNEL] for logging
+static const char* operTypeNames[3] = {"spts->fpts", "gradient", "correction"};
+#ifdef _BLAS
+static const char* operKernelNames[4] = {"dense[BLAS]", "line", "inject", "generated"};
+#else
+static const char* operKernelNames[4] = {"dense", "line", "inject", "generated"};
+#endif
+
+void solver::autotuneOperators(int eType, int order)
+{
+  oper &op = opers[eType][order];
+
+  vector<int> eleList;
+  for (uint i=0; i<eles.size(); i++)
+    if (eles[i].eType == eType && eles[i].order == order) eleList.push_back(i);
+
+  if (eleList.empty()) return;
+
+#ifdef _OPENMP
+  int nThreads = omp_get_max_threads();
+#else
+  int nThreads = 1;
+#endif
+
+  // Build flavour: determines which kernels are available
+  string build = "std";
+#ifdef _BLAS
+  build += "+blas";
+#endif
+#ifdef _GENKERNELS
+  build += "+gen";
+#endif
+#ifdef _MIXED_PRECISION
+  build += "+mixed";
+#endif
+
+  string sptsType = (eType == TRI) ? params->sptsTypeTri : params->sptsTypeQuad;
+  int vcjh = (eType == TRI) ? params->vcjhSchemeTri : params->vcjhSchemeQuad;
+
+  /* --- Read any previously-tuned choices:
+   * "eType order sptsType vcjhScheme denseOperators build nFields nThreads operType kernel" --- */
+  map<string,int> tuned;
+  ifstream cacheIn(params->autotuneFile.c_str());
+  string line;
+  while (getline(cacheIn,line)) {
+    if (line.empty() || line[0]=='#') continue;
+    stringstream ss(line);
+    vector<string> words;
+    string word;
+    while (ss >> word) words.push_back(word);
+    if (words.size() != 10) continue;  // Entry from an older cache format
+
+    string key = words[0];
+    for (int i=1; i<9; i++) key += " " + words[i];
+    tuned[key] = atoi(words[9].c_str());
+  }
+  cacheIn.close();
+
+  bool changed = false;
+  for (int opType=0; opType<3; opType++) {
+    vector<int> kernels = op.getKernels(opType);
+    if (kernels.size() == 1) continue;
+
+    stringstream ss;
+    ss << eType << " " << order << " " << sptsType << " " << vcjh << " " << params->denseOperators << " ";
+    ss << build << " " << params->nFields << " " << nThreads << " " << opType;
+    string key = ss.str();
+    if (tuned.count(key) && std::count(kernels.begin(),kernels.end(),tuned[key])) {
+      op.setKernel(opType,tuned[key]);
+      cout << "Autotune: eType " << eType << ", p=" << order << ", " << operTypeNames[opType];
+      cout << ": using " << operKernelNames[tuned[key]] << " kernel (cached)" << endl;
+      continue;
+    }
+
+    // Time each kernel applied to every element of this type & order
+    cout << "Autotune: eType " << eType << ", p=" << order << ", " << operTypeNames[opType] << ":";
+    double tBest = INFINITY;
+    int kBest = kernels[0];
+    for (auto& k:kernels) {
+      op.setKernel(opType,k);
+
+      std::chrono::steady_clock::time_point t0;
+      for (int rep=-1; rep<params->autotuneReps; rep++) {
+        if (rep == 0) t0 = std::chrono::steady_clock::now();  // First pass is a warm-up
+#pragma omp parallel for
+        for (uint i=0; i<eleList.size(); i++) {
+          ele &e = eles[eleList[i]];
+          switch (opType) {
+            case OPER_SPTS_FPTS:
+              op.applySptsFpts(e.U_spts,e.U_fpts);
+              break;
+            case OPER_GRAD:
+              op.applyDivFSpts(e.F_spts,e.divF_spts[0]);
+              break;
+            case OPER_CORRECTION:
+              op.applyCorrectDivF(e.dFn_fpts,e.divF_spts[0]);
+              break;
+          }
+        }
+      }
+      std::chrono::duration<double> tRun = std::chrono::steady_clock::now() - t0;
+      double t = tRun.count()/params->autotuneReps/eleList.size();
+      cout << " " << operKernelNames[k] << " " << t*1e6 << "us";
+
+      if (t < tBest) {
+        tBest = t;
+        kBest = k;
+      }
     }
+
+    op.setKernel(opType,kBest);
+    cout << " -> " << operKernelNames[kBest] << endl;
+
+    tuned[key] = kBest;
+    changed = true;
   }
+
+  if (!changed) return;
+
+  ofstream cacheOut(params->autotuneFile.c_str());
+  if (!cacheOut.is_open()) {
+    cout << "Autotune: Unable to write " << params->autotuneFile << endl;
+    return;
+  }
+  cacheOut << "# eType order sptsType vcjhScheme denseOperators build nFields nThreads operType kernel" << endl;
+  for (auto& t:tuned)
+    cacheOut << t.first << " " << t.second << endl;
 }
 
 void solver::initializeSolution()
@@ -341,3 +775,222 @@ void solver::initializeSolution()
     eles[i].setInitialCondition();
   }
 }
+
+void solver::storeResidualNorm(void)
+{
+  // Smoothing & preconditioning overwrite divF_spts in place; keep the norm of the true residual
+  if (params->lowMachPrecon || params->resSmooth)
+    resNorm = calcResidualNorm(params->resType);
+}
+
+vector<double> solver::getResidualNorm(int normType)
+{
+  if ((params->lowMachPrecon || params->resSmooth) && normType == params->resType && !resNorm.empty())
+    return resNorm;
+
+  return calcResidualNorm(normType);
+}
+
+vector<double> solver::calcResidualNorm(int normType)
+{
+  vector<double> res(params->nFields,0), resTmp(params->nFields);
+
+  for (auto& e:eles) {
+    resTmp = e.getResidual(normType);
+    if(checkNaN(resTmp)) FatalError("NaN Encountered in Solution Residual!");
+
+    for (int i=0; i<params->nFields; i++) {
+      if (normType == 3) {
+        // Infinity norm [max residual over all spts]
+        res[i] = max(res[i],resTmp[i]);
+      }else{
+        res[i] += resTmp[i];
+      }
+    }
+  }
+
+  // If taking 2-norm, res is sum squared; take sqrt to complete
+  if (normType == 2) {
+    for (auto& i:res) i = sqrt(i);
+  }
+
+  return res;
+}
+
+bool solver::checkConvergence(vector<double> &res)
+{
+  // Only consider convergence at the final polynomial order
+  if (params->order < params->orderFinal) return false;
+
+  // Skip the off-cadence output at the first iteration (initial transient)
+  if (params->iter%params->monitor_res_freq != 0) return false;
+
+  // The peak residual is the reference for the residual drop [from a freestream
+  // start, the residual first grows by orders of magnitude]
+  if (convResPeak.empty()) {
+    convResPeak = res;
+    convResHist.clear();
+  }
+
+  for (int i=0; i<params->nFields; i++)
+    convResPeak[i] = max(convResPeak[i],res[i]);
+
+  // Max. residual over all fields, relative to the reference residual
+  double resMax = 0;
+  for (int i=0; i<params->nFields; i++) {
+    if (convResPeak[i] > 0)
+      resMax = max(resMax, res[i]/convResPeak[i]);
+  }
+
+  if (params->convResDrop > 0 && resMax <= params->convResDrop) {
+    cout << "Convergence: Residual has dropped by " << params->convResDrop;
+    cout << " at iteration " << params->iter << endl;
+    return true;
+  }
+
+  // Only track stagnation once every field has come down from its peak
+  if (resMax < 1.) convResHist.push_back(resMax);
+
+  int window = params->convStagWindow;
+  if (window > 0 && (int)convResHist.size() >= 2*window) {
+    // Stagnated if the last 'window' entries did not improve on the previous window's minimum
+    auto itWin = convResHist.end() - window;
+    double minOld = *std::min_element(itWin - window,itWin);
+    double minNew = *std::min_element(itWin,convResHist.end());
+    if (minNew >= (1.-params->convStagTol)*minOld) {
+      cout << "Convergence: Residual has stagnated over the last " << window;
+      cout << " residual outputs at iteration " << params->iter << endl;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void solver::checkOrderElevation(vector<double> &res)
+{
+  if (params->order >= params->orderFinal) return;
+
+  // The peak residual at the current order is the reference for the residual drop
+  // [from a freestream start, the first residual is far below the transient's peak]
+  if (pSeqResPeak.empty()) {
+    pSeqResPeak = res;
+    return;
+  }
+
+  for (int i=0; i<params->nFields; i++)
+    pSeqResPeak[i] = max(pSeqResPeak[i],res[i]);
+
+  // Wait until every field has dropped by the requested amount
+  for (int i=0; i<params->nFields; i++) {
+    if (pSeqResPeak[i] > 0 && res[i] > params->pSeqResDrop*pSeqResPeak[i]) return;
+  }
+
+  cout << "p-Sequencing: Elevating polynomial order from " << params->order;
+  cout << " to " << params->order+1 << " at iteration " << params->iter << endl;
+
+  changeOrder(params->order+1);
+
+  pSeqResPeak.clear();
+}
+
+void solver::changeOrder(int newOrder)
+{
+  int oldOrder = params->order;
+
+  // Store the current solution at the old solution points
+  vector<matrix<flt>> U_old(eles.size());
+  for (uint i=0; i<eles.size(); i++)
+    U_old[i] = eles[i].U_spts;
+
+  // Interpolation operator from the old to the new solution points for each element type
+  map<int,matrix<flt>> opp_interp;
+  for (auto& e:eTypes) {
+    vector<point> loc_spts_old = Geo->getLocSpts(e,oldOrder);
+    vector<point> loc_spts_new = Geo->getLocSpts(e,newOrder);
+    opers[e][oldOrder].setupInterpolate(loc_spts_old,loc_spts_new,opp_interp[e]);
+  }
+
+  /* Re-setup all elements, faces, and operators at the new order */
+  params->order = newOrder;
+
+  // Start from fresh objects, so no storage sized for a lower order is carried over
+  vector<ele>().swap(eles);
+  vector<face>().swap(faces);
+  vector<bound>().swap(bounds);
+
+  Geo->setupElesFaces(eles,faces,bounds);
+
+  setupOperators();
+
+  setupBoundGroups();
+
+  if (params->resSmooth) setupResidualSmoothing();
+
+  if (params->pSeq) setPSeqTimeStep();
+
+  /* Interpolate the old solution to the new solution points */
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    opp_interp[eles[i].eType].timesMatrix(U_old[i],eles[i].U_spts);
+  }
+
+  if (params->leanMemory && params->order == params->orderFinal) releaseSetupData();
+
+  reportMemory();
+}
+
+void solver::releaseSetupData(void)
+{
+  size_t eleBytes = 0;
+#pragma omp parallel for reduction(+:eleBytes)
+  for (uint i=0; i<eles.size(); i++) {
+    eleBytes += eles[i].releaseSetupData();
+  }
+
+  size_t geoBytes = Geo->releaseConnectivity();
+
+  // Operators for any lower orders used during p-sequencing are no longer needed
+  polyOrders.clear();
+  for (auto& e:eles) polyOrders[e.eType].insert(e.order);
+  for (auto& e:eTypes) {
+    for (auto it=opers[e].begin(); it!=opers[e].end(); ) {
+      if (polyOrders[e].count(it->first)) it++;
+      else it = opers[e].erase(it);
+    }
+  }
+
+  cout << "Lean memory: released " << (geoBytes+eleBytes)/1048576. << " MB (geometry: ";
+  cout << geoBytes/1048576. << " MB, elements: " << eleBytes/1048576. << " MB)" << endl;
+}
+
+void solver::reportMemory(void)
+{
+  eleMemUsage mem;
+  for (auto& e:eles) mem += e.getMemUsage();
+
+  double nEles = max((double)eles.size(),1.);
+
+  // Independent of the residual output's stream state
+  ios::fmtflags flags = cout.flags();
+  streamsize prec = cout.precision();
+  cout.unsetf(ios::floatfield);
+  cout << setprecision(4);
+
+  cout << "Element memory: " << mem.total()/nEles/1024. << " kB/element, " << mem.total()/1048576. << " MB total" << endl;
+  cout << "  kB/element: solution " << mem.solution/nEles/1024. << ", flux " << mem.flux/nEles/1024.;
+  cout << ", gradients " << mem.gradients/nEles/1024. << ", geometry " << mem.geometry/nEles/1024.;
+  cout << ", motion " << mem.motion/nEles/1024. << ", other " << mem.other/nEles/1024. << endl;
+
+  cout.flags(flags);
+  cout.precision(prec);
+}
+
+void solver::setPSeqTimeStep(void)
+{
+  // Explicit time-step limit scales roughly as 1/(2p+1)
+  if (params->pSeqScaleDt)
+    params->dt = params->dtFinal*(2.*params->orderFinal+1.)/(2.*params->order+1.);
+  else
+    params->dt = params->dtFinal;
+}